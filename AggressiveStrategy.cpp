@@ -32,35 +32,43 @@ AggressiveStrategy::AggressiveStrategy(const Game& game) : Strategy(game) {
     }
 
     _tavern.push_back(TAVERN);
+
+    for(int i=0; i<4; ++i) {
+        _toHero[i].setGoal({ getHeroFromIndex(i) });
+    }
 }
 
 Direction AggressiveStrategy::getMove() {
-    std::vector<Tile> goal = _goal;
+    const Position& position = _game.state.heroes[_heroNumber].position;
 
+    // Nearest mine or hero with mines; heroes aren't in DistanceFields, their routes are repaired from the last turn
+    Path::Result path1 = Path::query(_game.state, position, _goal);
     for(int i=0; i<4; ++i) {
         if(i != _heroNumber && _game.state.heroes[i].mine_positions.size() > 0) {
-            goal.push_back(getHeroFromIndex(i));
+            Path::Result toHero = _toHero[i].query(_game.state, position);
+            if(toHero.found() && (!path1.found() || toHero.distance < path1.distance)) {
+                path1 = toHero;
+            }
         }
     }
 
-    Path::PathType path1 = Path::getPath(_game.state, _game.state.heroes[_heroNumber].position, goal);
-    Path::PathType path2 = Path::getPath(_game.state, _game.state.heroes[_heroNumber].position, _tavern, _avoid);
+    Path::Result path2 = Path::query(_game.state, _game.state.heroes[_heroNumber].position, _tavern, _avoid);
 
     int health = _game.state.heroes[_heroNumber].life;
 
-    Path::PathType path;
+    Path::Result path;
 
-    if(health-(int)path1.size() < 20) {
+    if(health-path1.distance < 20) {
         path = path2;
     } else {
         path = path1;
     }
 
-    if(path.size() == 0) {
+    if(!path.found()) {
         return STAY;
     }
 
-    return Path::getDirection(_game.state.heroes[_heroNumber].position, path.front());
+    return path.direction;
 }
 
 Tile AggressiveStrategy::getHeroFromIndex(int index) {
@@ -6,6 +6,7 @@
 
 #include "AggressiveStrategy2.h"
 #include "Path.h"
+#include "HeroRace.h"
 
 AggressiveStrategy2::AggressiveStrategy2(const Game& game) : Strategy(game) {
     Tile playerMine;
@@ -31,18 +32,26 @@ AggressiveStrategy2::AggressiveStrategy2(const Game& game) : Strategy(game) {
     }
 
     _tavern.push_back(TAVERN);
+
+    for(int i=0; i<4; ++i) {
+        _toHero[i].setGoal({ getHeroFromIndex(i) });
+    }
 }
 
 Direction AggressiveStrategy2::getMove() {
     std::vector<Tile> goal = _goal;
     std::vector<Tile> avoid;
     int health = _game.state.heroes[_heroNumber].life;
+    // Distances of every hero to every cell, from one BFS for the whole turn; ours to a hero comes from
+    // its route, repaired from the last turn
+    const HeroRace& race = HeroRace::get(_game.state);
+    const std::vector<Position>& taverns = _game.state.get_map_index()->getTaverns();
 
     for(int i=0; i<4; ++i) {
         if(i != _heroNumber && _game.state.heroes[i].mine_positions.size() > 0 && _game.state.heroes[i].life < health) {
-            Path::PathType toHero = Path::getPath(_game.state, _game.state.heroes[_heroNumber].position, getHeroFromIndex(i));
-            Path::PathType heroToTavern = Path::getPath(_game.state, _game.state.heroes[i].position, TAVERN);
-            if(toHero.size() < heroToTavern.size()) {
+            Path::Result toHero = _toHero[i].query(_game.state, _game.state.heroes[_heroNumber].position);
+            int heroToTavern = race.getDistance(i, taverns);
+            if(toHero.found() && toHero.distance < heroToTavern) {
                 goal.push_back(getHeroFromIndex(i));
             }
         } else if(i != _heroNumber && _game.state.heroes[i].life > health) {
@@ -50,22 +59,22 @@ Direction AggressiveStrategy2::getMove() {
         }
     }
 
-    Path::PathType path1 = Path::getPath(_game.state, _game.state.heroes[_heroNumber].position, goal, avoid);
-    Path::PathType path2 = Path::getPath(_game.state, _game.state.heroes[_heroNumber].position, _tavern, _avoid);
+    Path::Result path1 = Path::query(_game.state, _game.state.heroes[_heroNumber].position, goal, avoid);
+    Path::Result path2 = Path::query(_game.state, _game.state.heroes[_heroNumber].position, _tavern, _avoid);
 
-    Path::PathType path;
+    Path::Result path;
     
-    if(health-(int)path1.size() < 30) {
+    if(health-path1.distance < 30) {
         path = path2;
     } else {
         path = path1;
     }
 
-    if(path.size() == 0) {
+    if(!path.found()) {
         return STAY;
     }
 
-    return Path::getDirection(_game.state.heroes[_heroNumber].position, path.front());
+    return path.direction;
 }
 
 Tile AggressiveStrategy2::getHeroFromIndex(int index) {
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "Strategy.h"
+#include "Route.h"
 
 class AggressiveStrategy2 : public Strategy {
     public:
@@ -21,5 +22,6 @@ class AggressiveStrategy2 : public Strategy {
         std::vector<Tile> _goal;
         std::vector<Tile> _avoid;
         std::vector<Tile> _tavern;
+        Route _toHero[4];       // to every other hero, kept between turns
 };
 
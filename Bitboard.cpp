@@ -0,0 +1,76 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "Bitboard.h"
+
+const int Bitboard::MAX_SIZE;
+
+Bitboard::Bitboard() : _width(0), _height(0), _mask(0), _rows() {
+
+}
+
+Bitboard::Bitboard(int width, int height) : _width(width), _height(height), _rows() {
+    _mask = (height >= MAX_SIZE) ? ~Row(0) : ((Row(1) << height) - 1);
+}
+
+bool Bitboard::isEmpty() const {
+    Row any = 0;
+    for(int x = 0; x < _width; ++x) {
+        any |= _rows[x];
+    }
+
+    return any == 0;
+}
+
+int Bitboard::count() const {
+    int result = 0;
+    for(int x = 0; x < _width; ++x) {
+        result += __builtin_popcountll(_rows[x]);
+    }
+
+    return result;
+}
+
+Bitboard& Bitboard::operator|=(const Bitboard& other) {
+    for(int x = 0; x < _width; ++x) {
+        _rows[x] |= other._rows[x];
+    }
+
+    return *this;
+}
+
+Bitboard& Bitboard::operator&=(const Bitboard& other) {
+    for(int x = 0; x < _width; ++x) {
+        _rows[x] &= other._rows[x];
+    }
+
+    return *this;
+}
+
+Bitboard& Bitboard::subtract(const Bitboard& other) {
+    for(int x = 0; x < _width; ++x) {
+        _rows[x] &= ~other._rows[x];
+    }
+
+    return *this;
+}
+
+Bitboard Bitboard::getNeighbours() const {
+    Bitboard result(_width, _height);
+    for(int x = 0; x < _width; ++x) {
+        Row above = (x > 0) ? _rows[x - 1] : 0;
+        result._rows[x] = (((_rows[x] << 1) | (_rows[x] >> 1)) & _mask) | above | _rows[x + 1];
+    }
+
+    return result;
+}
+
+Bitboard Bitboard::flood(const Bitboard& walkable, const Bitboard& sources) {
+    Bitboard result(sources);
+    expand(walkable, walkable, sources, [&result](int, const Bitboard& ring) { result |= ring; });
+
+    return result;
+}
@@ -0,0 +1,138 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef BITBOARD_H_INCLUDED
+#define BITBOARD_H_INCLUDED
+
+#include <cstdint>
+
+/**
+ * Set of board cells packed one machine word per row (row x, bit y), for boards up to
+ * 64x64 - every Vindinium map fits. Cells are indexed as `x * height + y`, like in MapIndex.
+ *
+ * Neighbourhood of the whole set is a few shifts, ANDs and ORs per row, so flood fills,
+ * reachability checks and BFS distance rings (see expand()) cost a handful of word
+ * operations per layer instead of a queue push per cell.
+ */
+class Bitboard {
+    public:
+        typedef std::uint64_t Row;
+
+        static const int MAX_SIZE = 64;
+
+    public:
+        Bitboard();
+        // Empty set; 'width' and 'height' must fit (see fits())
+        Bitboard(int width, int height);
+
+        static bool fits(int width, int height) { return width > 0 && height > 0 && width <= MAX_SIZE && height <= MAX_SIZE; }
+
+        int getWidth() const { return _width; }
+        int getHeight() const { return _height; }
+        Row getRow(int x) const { return _rows[x]; }
+
+        bool get(int index) const { return (_rows[index / _height] >> (index % _height)) & 1; }
+        void set(int index) { _rows[index / _height] |= Row(1) << (index % _height); }
+        void reset(int index) { _rows[index / _height] &= ~(Row(1) << (index % _height)); }
+
+        bool isEmpty() const;
+        int count() const;
+
+        Bitboard& operator|=(const Bitboard& other);
+        Bitboard& operator&=(const Bitboard& other);
+        // Removes cells of 'other' from this set
+        Bitboard& subtract(const Bitboard& other);
+
+        // Cells 4-adjacent to any cell of this set (clipped to the board)
+        Bitboard getNeighbours() const;
+
+        // Calls visitor(index) for every cell of the set, in index order
+        template<typename Visitor>
+        void forEach(Visitor visitor) const;
+
+        // Cells reachable from 'sources' by walking through 'walkable' cells (sources included)
+        static Bitboard flood(const Bitboard& walkable, const Bitboard& sources);
+
+        // BFS by whole layers. Calls visitor(distance, ring) with the sources (distance 0) and then with
+        // every ring of cells first reached in 'distance' steps. Cells of 'reachable' can be reached, but
+        // only those of 'walkable' lead further (path ends may be any tile, same as in Path).
+        // Stops after 'maxDistance' steps (-1 for no limit); returns the distance of the last ring.
+        template<typename Visitor>
+        static int expand(const Bitboard& walkable, const Bitboard& reachable, const Bitboard& sources,
+                          Visitor visitor, int maxDistance = -1);
+
+    private:
+        int _width;
+        int _height;
+        Row _mask;                  // bits of the cells of one row
+        Row _rows[MAX_SIZE + 1];    // rows past _width are always zero
+};
+
+/*** Template methods ***/
+
+template<typename Visitor>
+void Bitboard::forEach(Visitor visitor) const {
+    for(int x = 0; x < _width; ++x) {
+        for(Row row = _rows[x]; row != 0; row &= row - 1) {
+            visitor(x * _height + __builtin_ctzll(row));
+        }
+    }
+}
+
+template<typename Visitor>
+int Bitboard::expand(const Bitboard& walkable, const Bitboard& reachable, const Bitboard& sources,
+                     Visitor visitor, int maxDistance) {
+    const int width = sources._width;
+    const Row mask = sources._mask;
+
+    Bitboard visited(sources);
+    Bitboard frontier(sources);
+    Bitboard ring(sources);
+
+    visitor(0, ring);
+
+    int distance = 0;
+    while(distance != maxDistance) {
+        // One pass per layer: new ring is the neighbourhood of the frontier not seen before.
+        // _rows has a zero row past the last one, so rows above and below need no bound checks
+        Row any = 0;
+        Row above = 0;
+        Row current = frontier._rows[0];
+        for(int x = 0; x < width; ++x) {
+            Row below = frontier._rows[x + 1];
+            Row reached = ((((current << 1) | (current >> 1)) & mask) | above | below) & reachable._rows[x] & ~visited._rows[x];
+
+            ring._rows[x] = reached;
+            visited._rows[x] |= reached;
+            any |= reached;
+
+            above = current;
+            current = below;
+        }
+
+        if(any == 0) {
+            break;
+        }
+
+        ++distance;
+        visitor(distance, ring);
+
+        // Next frontier is the part of the ring that can be walked through
+        Row walking = 0;
+        for(int x = 0; x < width; ++x) {
+            frontier._rows[x] = ring._rows[x] & walkable._rows[x];
+            walking |= frontier._rows[x];
+        }
+
+        if(walking == 0) {
+            break;
+        }
+    }
+
+    return distance;
+}
+
+#endif
@@ -0,0 +1,498 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "CorridorGraph.h"
+#include "MapIndex.h"
+
+#include <climits>
+#include <cstdlib>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+/*** Search memory reused by consecutive queries of the calling thread ***/
+struct CorridorWorkspace {
+    CorridorWorkspace() : generation(0) {
+
+    }
+
+    void reset(int cells) {
+        if(static_cast<int>(stamp.size()) != cells) {
+            stamp.assign(cells, 0);
+            closed.assign(cells, 0);
+            goalStamp.assign(cells, 0);
+            blockedStamp.assign(cells, 0);
+            distance.assign(cells, 0);
+            parent.assign(cells, -1);
+            parentEdge.assign(cells, -1);
+            seedCell.assign(cells, -1);
+            seedSide.assign(cells, 0);
+            goalCost.assign(cells, 0);
+            goalCell.assign(cells, -1);
+            goalSide.assign(cells, 0);
+            generation = 0;
+        }
+
+        if(++generation == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            std::fill(closed.begin(), closed.end(), 0);
+            std::fill(goalStamp.begin(), goalStamp.end(), 0);
+            std::fill(blockedStamp.begin(), blockedStamp.end(), 0);
+            generation = 1;
+        }
+
+        blocked.clear();
+        sources.clear();
+        targets.clear();
+        heap.clear();
+    }
+
+    void block(int cell) {
+        if(blockedStamp[cell] != generation) {
+            blockedStamp[cell] = generation;
+            blocked.push_back(cell);
+        }
+    }
+
+    bool isBlocked(int cell) const { return blockedStamp[cell] == generation; }
+    bool hasDistance(int junction) const { return stamp[junction] == generation; }
+    bool isClosed(int junction) const { return closed[junction] == generation; }
+    bool hasGoal(int junction) const { return goalStamp[junction] == generation; }
+
+    // Keeps the cheaper way from 'junction' to the goal: through 'cell', leaving the junction on 'side'
+    void setGoal(int junction, int cost, int cell, int side) {
+        if(hasGoal(junction) && goalCost[junction] <= cost) {
+            return;
+        }
+
+        goalStamp[junction] = generation;
+        goalCost[junction] = cost;
+        goalCell[junction] = cell;
+        goalSide[junction] = side;
+    }
+
+    unsigned int generation;
+    std::vector<unsigned int> stamp;        // distance and parents valid in this query
+    std::vector<unsigned int> closed;
+    std::vector<unsigned int> goalStamp;    // goalCost/goalCell/goalSide valid in this query
+    std::vector<unsigned int> blockedStamp;
+    std::vector<int> distance;
+    std::vector<int> parent;                // previous junction, -1 for junctions entered from a source cell
+    std::vector<int> parentEdge;
+    std::vector<int> seedCell;              // source cell of a junction without parent, and the side it was left on
+    std::vector<int> seedSide;
+    std::vector<int> goalCost;              // cells from the junction to the goal
+    std::vector<int> goalCell;              // target cell the junction leads to, and the side the junction is on
+    std::vector<int> goalSide;
+
+    std::vector<int> blocked;
+    std::vector<std::pair<int, int>> sources;   // (cell, cost): first cells walked through from the start
+    std::vector<std::pair<int, int>> targets;   // (cell, cost): last cells walked through before the goal
+    std::vector<std::pair<int, int>> heap;      // (f, junction)
+    std::vector<int> junctions;                 // junctions of the found path
+};
+
+CorridorGraph::CorridorGraph() : _junctionCount(0) {
+
+}
+
+void CorridorGraph::compute(const MapIndex& mapIndex) {
+    const int cells = mapIndex.getWidth() * mapIndex.getHeight();
+
+    _junction.assign(cells, false);
+    _corridorOf.assign(cells, -1);
+    _offsetOf.assign(cells, 0);
+    _corridors.clear();
+    _chain.clear();
+
+    for(int index = 0; index < cells; ++index) {
+        if(!mapIndex.isPassable(index)) {
+            continue;
+        }
+
+        // Cells next to taverns and mines are where paths to them end, so they must be junctions
+        int degree = 0;
+        bool nextToGoal = false;
+        const int* neighbours = mapIndex.getNeighbours(index);
+        for(int direction = 0; direction < 4; ++direction) {
+            int neighbour = neighbours[direction];
+            if(neighbour < 0) {
+                continue;
+            }
+
+            if(mapIndex.isPassable(neighbour)) {
+                ++degree;
+            } else {
+                nextToGoal = true;
+            }
+        }
+
+        _junction[index] = (degree != 2 || nextToGoal);
+    }
+
+    std::vector<std::vector<Edge>> edges(cells);
+
+    // Follows every corridor leaving 'junction' that isn't known yet to the junction at its other end
+    auto trace = [&](int junction) {
+        const int* neighbours = mapIndex.getNeighbours(junction);
+
+        for(int direction = 0; direction < 4; ++direction) {
+            int next = neighbours[direction];
+            if(next < 0 || !mapIndex.isPassable(next)) {
+                continue;
+            }
+
+            if(_junction[next]) {
+                Edge edge = { next, 1, -1, true };
+                edges[junction].push_back(edge);
+                continue;
+            }
+
+            if(_corridorOf[next] >= 0) {
+                continue;
+            }
+
+            const int id = _corridors.size();
+            Corridor corridor;
+            corridor.begin = _chain.size();
+            corridor.ends[0] = junction;
+
+            int previous = junction, length = 0;
+            while(!_junction[next]) {
+                _corridorOf[next] = id;
+                _offsetOf[next] = length++;
+                _chain.push_back(next);
+
+                int following = -1;
+                const int* around = mapIndex.getNeighbours(next);
+                for(int d = 0; d < 4; ++d) {
+                    if(around[d] >= 0 && around[d] != previous && mapIndex.isPassable(around[d])) {
+                        following = around[d];
+                    }
+                }
+
+                previous = next;
+                next = following;
+            }
+
+            corridor.length = length;
+            corridor.ends[1] = next;
+            _corridors.push_back(corridor);
+
+            // Corridors leading back to their own junction never shorten a path through it
+            if(next != junction) {
+                Edge forward = { next, length + 1, id, true };
+                Edge backward = { junction, length + 1, id, false };
+                edges[junction].push_back(forward);
+                edges[next].push_back(backward);
+            }
+        }
+    };
+
+    for(int index = 0; index < cells; ++index) {
+        if(_junction[index]) {
+            trace(index);
+        }
+    }
+
+    // Loops without any junction are cut open at one of their cells
+    for(int index = 0; index < cells; ++index) {
+        if(mapIndex.isPassable(index) && !_junction[index] && _corridorOf[index] < 0) {
+            _junction[index] = true;
+            trace(index);
+        }
+    }
+
+    _junctionCount = std::count(_junction.begin(), _junction.end(), true);
+
+    _edgeBegin.assign(cells + 1, 0);
+    _edges.clear();
+    for(int index = 0; index < cells; ++index) {
+        _edgeBegin[index] = _edges.size();
+        _edges.insert(_edges.end(), edges[index].begin(), edges[index].end());
+    }
+    _edgeBegin[cells] = _edges.size();
+}
+
+int CorridorGraph::query(const MapIndex& mapIndex, const std::vector<int>& blocked, int start, int goal,
+                         std::vector<int>* path, unsigned int* expansions) const {
+    static thread_local CorridorWorkspace workspace;
+    CorridorWorkspace& ws = workspace;
+
+    if(path) {
+        path->clear();
+    }
+    if(expansions) {
+        *expansions = 0;
+    }
+
+    if(start < 0 || goal < 0) {
+        return 0;
+    }
+
+    // The goal is entered from any cell next to it, even when one of them is WOOD (left out of the adjacency)
+    const Position startPosition = mapIndex.getPosition(start);
+    const Position goalPosition = mapIndex.getPosition(goal);
+    if(start == goal || std::abs(startPosition.x - goalPosition.x) + std::abs(startPosition.y - goalPosition.y) == 1) {
+        if(path) {
+            path->push_back(goal);
+        }
+        return 1;
+    }
+
+    ws.reset(_junction.size());
+    for(int cell : blocked) {
+        if(cell >= 0 && cell != start && cell != goal) {
+            ws.block(cell);
+        }
+    }
+
+    auto isWalkable = [&](int cell) {
+        return mapIndex.isPassable(cell) && !ws.isBlocked(cell);
+    };
+
+    // True if no blocked cell of 'corridor' lies between offsets 'from' and 'to' (inclusive, any order)
+    auto isClear = [&](int corridor, int from, int to) {
+        if(from > to) {
+            std::swap(from, to);
+        }
+
+        for(int cell : ws.blocked) {
+            if(_corridorOf[cell] == corridor && _offsetOf[cell] >= from && _offsetOf[cell] <= to) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    // The start and the goal themselves are walked through only when they are EMPTY
+    if(mapIndex.isPassable(start)) {
+        ws.sources.push_back(std::make_pair(start, 0));
+    } else {
+        const int* neighbours = mapIndex.getNeighbours(start);
+        for(int direction = 0; direction < 4; ++direction) {
+            if(neighbours[direction] >= 0 && isWalkable(neighbours[direction])) {
+                ws.sources.push_back(std::make_pair(neighbours[direction], 1));
+            }
+        }
+    }
+
+    if(mapIndex.isPassable(goal)) {
+        ws.targets.push_back(std::make_pair(goal, 0));
+    } else {
+        const int* neighbours = mapIndex.getNeighbours(goal);
+        for(int direction = 0; direction < 4; ++direction) {
+            if(neighbours[direction] >= 0 && isWalkable(neighbours[direction])) {
+                ws.targets.push_back(std::make_pair(neighbours[direction], 1));
+            }
+        }
+    }
+
+    int bestCost = INT_MAX, bestSource = -1, bestTarget = -1, bestJunction = -1;
+
+    // Source and target in the same corridor (or the same cell) are joined without any junction
+    for(const std::pair<int, int>& source : ws.sources) {
+        for(const std::pair<int, int>& target : ws.targets) {
+            int cost = INT_MAX;
+            int corridor = _corridorOf[source.first];
+
+            if(source.first == target.first) {
+                cost = source.second + target.second;
+            } else if(corridor >= 0 && corridor == _corridorOf[target.first] &&
+                      isClear(corridor, _offsetOf[source.first], _offsetOf[target.first])) {
+                cost = source.second + std::abs(_offsetOf[source.first] - _offsetOf[target.first]) + target.second;
+            }
+
+            if(cost < bestCost) {
+                bestCost = cost;
+                bestSource = source.first;
+                bestTarget = target.first;
+            }
+        }
+    }
+
+    // A* bound of a junction: Manhattan distance to the goal or, when larger, the landmark bound
+    const LandmarkTable::Target target = mapIndex.getLandmarks().getTarget(goal);
+    auto push = [&](int junction, int cost, int parent, int parentEdge) {
+        ws.stamp[junction] = ws.generation;
+        ws.distance[junction] = cost;
+        ws.parent[junction] = parent;
+        ws.parentEdge[junction] = parentEdge;
+
+        Position position = mapIndex.getPosition(junction);
+        int bound = std::abs(position.x - goalPosition.x) + std::abs(position.y - goalPosition.y);
+        if(junction != goal) {
+            bound = std::max(bound, mapIndex.getLandmarks().getLowerBound(junction, target));
+        }
+        ws.heap.push_back(std::make_pair(cost + bound, junction));
+        std::push_heap(ws.heap.begin(), ws.heap.end(), std::greater<std::pair<int, int>>());
+    };
+
+    // Junctions at the ends of the corridors of the source cells start the search
+    auto seed = [&](int junction, int cost, int cell, int side) {
+        if(ws.isBlocked(junction) || (ws.hasDistance(junction) && ws.distance[junction] <= cost)) {
+            return;
+        }
+
+        push(junction, cost, -1, -1);
+        ws.seedCell[junction] = cell;
+        ws.seedSide[junction] = side;
+    };
+
+    for(const std::pair<int, int>& source : ws.sources) {
+        int cell = source.first, corridor = _corridorOf[cell];
+        if(_junction[cell]) {
+            seed(cell, source.second, cell, 0);
+            continue;
+        }
+
+        const Corridor& c = _corridors[corridor];
+        int offset = _offsetOf[cell];
+        if(isClear(corridor, 0, offset)) {
+            seed(c.ends[0], source.second + offset + 1, cell, -1);
+        }
+        if(isClear(corridor, offset, c.length - 1)) {
+            seed(c.ends[1], source.second + c.length - offset, cell, c.length);
+        }
+    }
+
+    for(const std::pair<int, int>& target : ws.targets) {
+        int cell = target.first, corridor = _corridorOf[cell];
+        if(_junction[cell]) {
+            ws.setGoal(cell, target.second, cell, 0);
+            continue;
+        }
+
+        const Corridor& c = _corridors[corridor];
+        int offset = _offsetOf[cell];
+        if(isClear(corridor, 0, offset)) {
+            ws.setGoal(c.ends[0], target.second + offset + 1, cell, -1);
+        }
+        if(isClear(corridor, offset, c.length - 1)) {
+            ws.setGoal(c.ends[1], target.second + c.length - offset, cell, c.length);
+        }
+    }
+
+    unsigned int expanded = 0;
+    while(!ws.heap.empty()) {
+        std::pop_heap(ws.heap.begin(), ws.heap.end(), std::greater<std::pair<int, int>>());
+        std::pair<int, int> top = ws.heap.back();
+        ws.heap.pop_back();
+
+        int current = top.second;
+        if(top.first >= bestCost) {
+            break;
+        }
+        if(ws.isClosed(current)) {
+            continue;
+        }
+
+        ws.closed[current] = ws.generation;
+        ++expanded;
+
+        if(ws.hasGoal(current) && ws.distance[current] + ws.goalCost[current] < bestCost) {
+            bestCost = ws.distance[current] + ws.goalCost[current];
+            bestJunction = current;
+        }
+
+        if(current == goal) {
+            continue;
+        }
+
+        for(int e = _edgeBegin[current]; e < _edgeBegin[current + 1]; ++e) {
+            const Edge& edge = _edges[e];
+            if(ws.isBlocked(edge.to) || ws.isClosed(edge.to) ||
+               (edge.corridor >= 0 && !isClear(edge.corridor, 0, _corridors[edge.corridor].length - 1))) {
+                continue;
+            }
+
+            int cost = ws.distance[current] + edge.weight;
+            if(!ws.hasDistance(edge.to) || cost < ws.distance[edge.to]) {
+                push(edge.to, cost, current, e);
+            }
+        }
+    }
+
+    if(expansions) {
+        *expansions = expanded;
+    }
+
+    if(bestCost == INT_MAX) {
+        return 0;
+    }
+
+    if(path) {
+        std::vector<int>& result = *path;
+
+        if(bestJunction < 0) {
+            if(bestSource != start) {
+                result.push_back(bestSource);
+            }
+            if(bestTarget != bestSource) {
+                _walk(_corridorOf[bestSource], _offsetOf[bestSource], _offsetOf[bestTarget], result);
+            }
+        } else {
+            ws.junctions.clear();
+            for(int junction = bestJunction; junction >= 0; junction = ws.parent[junction]) {
+                ws.junctions.push_back(junction);
+            }
+            std::reverse(ws.junctions.begin(), ws.junctions.end());
+
+            int first = ws.junctions.front();
+            int source = ws.seedCell[first];
+            if(source != start) {
+                result.push_back(source);
+            }
+            if(source != first) {
+                _walk(_corridorOf[source], _offsetOf[source], ws.seedSide[first], result);
+            }
+
+            for(std::size_t i = 1; i < ws.junctions.size(); ++i) {
+                const Edge& edge = _edges[ws.parentEdge[ws.junctions[i]]];
+                if(edge.corridor < 0) {
+                    result.push_back(edge.to);
+                } else {
+                    int length = _corridors[edge.corridor].length;
+                    _walk(edge.corridor, edge.forward ? -1 : length, edge.forward ? length : -1, result);
+                }
+            }
+
+            bestTarget = ws.goalCell[bestJunction];
+            if(bestTarget != bestJunction) {
+                _walk(_corridorOf[bestTarget], ws.goalSide[bestJunction], _offsetOf[bestTarget], result);
+            }
+        }
+
+        if(bestTarget != goal) {
+            result.push_back(goal);
+        }
+    }
+
+    return bestCost;
+}
+
+int CorridorGraph::_getCell(int corridor, int offset) const {
+    const Corridor& c = _corridors[corridor];
+
+    if(offset < 0) {
+        return c.ends[0];
+    }
+    if(offset >= c.length) {
+        return c.ends[1];
+    }
+
+    return _chain[c.begin + offset];
+}
+
+void CorridorGraph::_walk(int corridor, int from, int to, std::vector<int>& path) const {
+    int step = (from < to) ? 1 : -1;
+
+    for(int offset = from; offset != to; ) {
+        offset += step;
+        path.push_back(_getCell(corridor, offset));
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef CORRIDORGRAPH_H_INCLUDED
+#define CORRIDORGRAPH_H_INCLUDED
+
+#include <vector>
+#include <cstddef>
+
+class MapIndex;
+
+/**
+ * The map with its one-tile-wide corridors contracted into weighted edges.
+ *
+ * Junctions are the EMPTY cells where paths can branch or end: cells with other than two
+ * EMPTY neighbours and cells next to a tavern or mine. Every chain of the remaining cells
+ * (two EMPTY neighbours each) between two junctions is a corridor, an edge as long as the
+ * chain. A* on junctions skips whole corridors in one step, so maps made of rooms and
+ * corridors need far fewer expansions than a search cell by cell.
+ *
+ * Built once per map from the hero-free background. Heroes are passed to every query: a
+ * corridor with a hero in it can't be walked through, only walked into up to the hero.
+ */
+class CorridorGraph {
+    public:
+        CorridorGraph();
+
+        void compute(const MapIndex& mapIndex);
+
+        bool isJunction(int index) const { return _junction[index]; }
+        int getJunctionCount() const { return _junctionCount; }
+        int getCorridorCount() const { return _corridors.size(); }
+
+        // Shortest path under the Path rules (only EMPTY cells are walked through, the start and the
+        // goal may be any tile) where cells from 'blocked' (heroes) can't be walked through either.
+        // Returns the number of cells on the path (as Path::Result::distance), 0 if there is none;
+        // cell indices of the path are written to 'path' and junctions expanded to 'expansions' when given
+        int query(const MapIndex& mapIndex, const std::vector<int>& blocked, int start, int goal,
+                  std::vector<int>* path = NULL, unsigned int* expansions = NULL) const;
+
+    private:
+        // Cells _chain[begin .. begin + length), first one next to ends[0], last one next to ends[1]
+        struct Corridor {
+            int begin;
+            int length;
+            int ends[2];
+        };
+
+        struct Edge {
+            int to;
+            int weight;
+            int corridor;       // -1 for junctions next to each other
+            bool forward;       // walking the corridor from ends[0] to ends[1]
+        };
+
+        // Cell of 'corridor' at 'offset', where -1 and length stand for the end junctions
+        int _getCell(int corridor, int offset) const;
+        // Appends cells after 'from' up to and including 'to' (offsets as in _getCell)
+        void _walk(int corridor, int from, int to, std::vector<int>& path) const;
+
+        std::vector<bool> _junction;
+        int _junctionCount;
+        std::vector<int> _corridorOf;   // cell index -> corridor, -1 for junctions and cells not walked through
+        std::vector<int> _offsetOf;     // cell index -> place in its corridor
+        std::vector<Corridor> _corridors;
+        std::vector<int> _chain;
+        std::vector<int> _edgeBegin;    // cell index -> first of its edges in _edges, cells + 1 entries
+        std::vector<Edge> _edges;
+};
+
+#endif
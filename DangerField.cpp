@@ -0,0 +1,75 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "DangerField.h"
+#include "Path.h"
+
+#include <map>
+#include <memory>
+#include <cstdlib>
+
+const int DangerField::RADIUS;
+const double DangerField::PENALTY = 99999.0;
+
+DangerField::DangerField() : _width(0), _height(0) {
+
+}
+
+DangerField::DangerField(const State& state, const std::vector<Tile>& avoidTypes) {
+    std::vector<Position> avoidPositions;
+    Path::getTilePositions(state, avoidTypes, avoidPositions);
+
+    compute(*state.get_map_index(), avoidPositions);
+}
+
+void DangerField::compute(const MapIndex& mapIndex, const std::vector<Position>& avoidPositions) {
+    _width = mapIndex.getWidth();
+    _height = mapIndex.getHeight();
+    _penalties.assign(_width * _height, 0.0);
+
+    for(const Position& center : avoidPositions) {
+        for(int dx = -RADIUS; dx <= RADIUS; ++dx) {
+            int x = center.x + dx;
+            if(x < 0 || x >= _width) {
+                continue;
+            }
+
+            int dyMax = RADIUS - std::abs(dx);
+            for(int dy = -dyMax; dy <= dyMax; ++dy) {
+                int y = center.y + dy;
+                if(y >= 0 && y < _height) {
+                    _penalties[x * _height + y] = PENALTY;
+                }
+            }
+        }
+    }
+}
+
+const DangerField& DangerField::get(const State& state, const std::vector<Tile>& avoidTypes) {
+    static thread_local Hash hash = 0;
+    static thread_local std::map<int, std::unique_ptr<DangerField>> fields;
+
+    Hash stateHash = hash_value(state);
+    if(stateHash != hash) {
+        fields.clear();
+        hash = stateHash;
+    }
+
+    std::unique_ptr<DangerField>& field = fields[Path::getTileMask(avoidTypes)];
+    if(!field) {
+        field.reset(new DangerField(state, avoidTypes));
+    }
+
+    return *field;
+}
+
+double DangerField::getPenalty(const Position& position) const {
+    if(position.x < 0 || position.y < 0 || position.x >= _width || position.y >= _height) {
+        return 0.0;
+    }
+
+    return _penalties[position.x * _height + position.y];
+}
@@ -0,0 +1,49 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef DANGERFIELD_H_INCLUDED
+#define DANGERFIELD_H_INCLUDED
+
+#include "state.h"
+
+#include <vector>
+
+/**
+ * Avoidance penalty of every cell for one State and one set of avoided tile types:
+ * cells within Manhattan distance RADIUS of any avoided tile (hero, tavern, mine)
+ * cost PENALTY, every other cell costs nothing.
+ *
+ * Built once per state and avoid set (see get()), so path heuristics read the penalty
+ * with a single array access instead of checking every avoided tile.
+ */
+class DangerField {
+    public:
+        static const int RADIUS = 2;
+        static const double PENALTY;
+
+    public:
+        DangerField();
+        DangerField(const State& state, const std::vector<Tile>& avoidTypes);
+
+        // Refills the field for avoided tiles at 'avoidPositions', reusing its memory
+        void compute(const MapIndex& mapIndex, const std::vector<Position>& avoidPositions);
+
+        // Field of 'state' for 'avoidTypes', shared by every query of the calling thread with the same
+        // avoided tile types as long as the state hash doesn't change (valid until a call with another state)
+        static const DangerField& get(const State& state, const std::vector<Tile>& avoidTypes);
+
+        double getPenalty(const Position& position) const;
+        bool isDangerous(const Position& position) const { return getPenalty(position) != 0.0; }
+        // Same for a cell index (x * height + y) known to be on the board
+        bool isDangerous(int index) const { return _penalties[index] != 0.0; }
+
+    private:
+        int _width;
+        int _height;
+        std::vector<double> _penalties;
+};
+
+#endif
@@ -0,0 +1,403 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "DistanceField.h"
+
+#include <memory>
+#include <algorithm>
+
+static const int posDiffs[4][2] = {
+    { -1,  0 }, {  1,  0 }, {  0,  1 }, {  0, -1 }  // NORTH, SOUTH, EAST, WEST
+};
+
+static const Direction posDiffDirections[4] = {
+    NORTH, SOUTH, EAST, WEST
+};
+
+/*** DistanceField ***/
+
+const int DistanceField::UNREACHABLE;
+
+DistanceField::DistanceField() : _adjacency(NULL) {
+
+}
+
+void DistanceField::compute(const MapIndex& mapIndex, const std::vector<bool>& passable, const Bitboard& passableBoard,
+                            const std::vector<int>& sources) {
+    _adjacency = mapIndex.getAdjacency().data();
+    _values.assign(mapIndex.getWidth() * mapIndex.getHeight(), UNREACHABLE);
+
+    // Whole BFS layers at once when the board fits in a bitboard
+    if(passableBoard.getWidth() > 0) {
+        Bitboard sourceBoard(passableBoard.getWidth(), passableBoard.getHeight());
+        for(int source : sources) {
+            sourceBoard.set(source);
+        }
+
+        Bitboard::expand(passableBoard, passableBoard, sourceBoard, [this](int distance, const Bitboard& ring) {
+            ring.forEach([this, distance](int index) { _values[index] = distance; });
+        });
+        return;
+    }
+
+    _queue.clear();
+    for(int source : sources) {
+        _values[source] = 0;
+        _queue.push_back(source);
+    }
+
+    _lower(passable);
+}
+
+void DistanceField::addSource(int index, const std::vector<bool>& passable) {
+    _values[index] = 0;
+
+    _queue.clear();
+    _queue.push_back(index);
+    _lower(passable);
+}
+
+void DistanceField::removeSource(int index, const std::vector<bool>& passable) {
+    _raise(index, passable);
+}
+
+void DistanceField::block(int index, const std::vector<bool>& passable) {
+    _raise(index, passable);
+}
+
+void DistanceField::unblock(int index, const std::vector<bool>& passable) {
+    int best = UNREACHABLE;
+    for(int direction = 0; direction < 4; ++direction) {
+        int neighbour = _getNeighbour(index, direction);
+        if(neighbour >= 0 && _values[neighbour] != UNREACHABLE && (best == UNREACHABLE || _values[neighbour] + 1 < best)) {
+            best = _values[neighbour] + 1;
+        }
+    }
+
+    if(best == UNREACHABLE) {
+        return;
+    }
+
+    _values[index] = best;
+
+    _queue.clear();
+    _queue.push_back(index);
+    _lower(passable);
+}
+
+// BFS relaxation from cells in _queue (in non-decreasing value order) and,
+// merged by value, from _seeds (sorted); values only go down
+void DistanceField::_lower(const std::vector<bool>& passable) {
+    std::size_t head = 0;
+    std::size_t seed = 0;
+
+    while(head < _queue.size() || seed < _seeds.size()) {
+        int index;
+        if(seed < _seeds.size() && (head == _queue.size() || _seeds[seed].first < _values[_queue[head]])) {
+            index = _seeds[seed].second;
+            if(_values[index] != _seeds[seed++].first) {
+                continue; // lowered again since it was seeded
+            }
+        } else {
+            index = _queue[head++];
+        }
+
+        int value = _values[index] + 1;
+        for(int direction = 0; direction < 4; ++direction) {
+            int neighbour = _getNeighbour(index, direction);
+            if(neighbour < 0 || !passable[neighbour]) {
+                continue;
+            }
+
+            if(_values[neighbour] == UNREACHABLE || value < _values[neighbour]) {
+                _values[neighbour] = value;
+                _queue.push_back(neighbour);
+            }
+        }
+    }
+
+    _queue.clear();
+    _seeds.clear();
+}
+
+// Cell 'index' no longer leads to a goal: invalidate every cell whose only shortest
+// routes went through it, then recompute those cells from the surviving boundary
+void DistanceField::_raise(int index, const std::vector<bool>& passable) {
+    int oldValue = _values[index];
+    _values[index] = UNREACHABLE;
+
+    if(oldValue == UNREACHABLE) {
+        return;
+    }
+
+    // Invalidation runs level by level, so when a cell is checked all cells one step
+    // closer to the goals that lost their value are already marked
+    _invalidated.clear();
+    _invalidated.push_back(std::make_pair(index, oldValue));
+    for(std::size_t head = 0; head < _invalidated.size(); ++head) {
+        int current = _invalidated[head].first;
+        int currentValue = _invalidated[head].second;
+
+        for(int direction = 0; direction < 4; ++direction) {
+            int neighbour = _getNeighbour(current, direction);
+            if(neighbour < 0 || !passable[neighbour] || _values[neighbour] != currentValue + 1) {
+                continue;
+            }
+
+            bool supported = false;
+            for(int other = 0; other < 4 && !supported; ++other) {
+                int support = _getNeighbour(neighbour, other);
+                supported = (support >= 0 && _values[support] == currentValue);
+            }
+
+            if(!supported) {
+                _invalidated.push_back(std::make_pair(neighbour, _values[neighbour]));
+                _values[neighbour] = UNREACHABLE;
+            }
+        }
+    }
+
+    _seeds.clear();
+    for(std::size_t i = 1; i < _invalidated.size(); ++i) {
+        int current = _invalidated[i].first;
+        int best = UNREACHABLE;
+
+        for(int direction = 0; direction < 4; ++direction) {
+            int neighbour = _getNeighbour(current, direction);
+            if(neighbour >= 0 && _values[neighbour] != UNREACHABLE && (best == UNREACHABLE || _values[neighbour] + 1 < best)) {
+                best = _values[neighbour] + 1;
+            }
+        }
+
+        if(best != UNREACHABLE) {
+            _values[current] = best;
+            _seeds.push_back(std::make_pair(best, current));
+        }
+    }
+
+    std::sort(_seeds.begin(), _seeds.end());
+
+    _queue.clear();
+    _lower(passable);
+}
+
+/*** DistanceFields ***/
+
+DistanceFields::DistanceFields(const State& state) : _hash(hash_value(state)), _mapIndex(state.get_map_index()) {
+    _width = _mapIndex->getWidth();
+    _height = _mapIndex->getHeight();
+
+    const int cells = _width * _height;
+    _passable.assign(cells, false);
+    _occupancy.assign(cells, 0);
+    std::vector<int> sources[GOALS_COUNT];
+
+    for(const State::Hero& hero : state.heroes) {
+        int index = _getIndex(hero.position);
+        if(index >= 0) {
+            ++_occupancy[index];
+        }
+    }
+
+    Bitboard passableBoard = _mapIndex->getPassableBoard();
+    for(int index = 0; index < cells; ++index) {
+        _passable[index] = _mapIndex->isPassable(index) && _occupancy[index] == 0;
+        if(_occupancy[index] != 0 && passableBoard.getWidth() > 0) {
+            passableBoard.reset(index);
+        }
+    }
+
+    for(const Position& tavern : _mapIndex->getTaverns()) {
+        sources[TAVERNS].push_back(_getIndex(tavern));
+    }
+
+    for(const Position& mine : _mapIndex->getMines()) {
+        switch(state.get_tile_from_background(mine)) {
+            case MINE: sources[NEUTRAL_MINES].push_back(_getIndex(mine)); break;
+            case MINE1: sources[HERO1_MINES].push_back(_getIndex(mine)); break;
+            case MINE2: sources[HERO2_MINES].push_back(_getIndex(mine)); break;
+            case MINE3: sources[HERO3_MINES].push_back(_getIndex(mine)); break;
+            case MINE4: sources[HERO4_MINES].push_back(_getIndex(mine)); break;
+            default: break;
+        }
+    }
+
+    for(int goal = 0; goal < GOALS_COUNT; ++goal) {
+        _fields[goal].compute(*_mapIndex, _passable, passableBoard, sources[goal]);
+    }
+}
+
+const DistanceFields& DistanceFields::get(const State& state) {
+    static thread_local std::unique_ptr<DistanceFields> fields;
+
+    const DistanceFields* attached = dynamic_cast<const DistanceFields*>(state.get_observer());
+    if(attached) {
+        return *attached;
+    }
+
+    if(!fields || fields->_hash != hash_value(state)) {
+        fields.reset(new DistanceFields(state));
+    }
+
+    return *fields;
+}
+
+void DistanceFields::hero_moved(const int&, const Position& from, const Position& to) {
+    int fromIndex = _getIndex(from);
+    int toIndex = _getIndex(to);
+
+    if(fromIndex == toIndex) {
+        return;
+    }
+
+    if(fromIndex >= 0 && --_occupancy[fromIndex] == 0) {
+        _passable[fromIndex] = true;
+        for(DistanceField& field : _fields) {
+            field.unblock(fromIndex, _passable);
+        }
+    }
+
+    if(toIndex >= 0 && _occupancy[toIndex]++ == 0) {
+        _passable[toIndex] = false;
+        for(DistanceField& field : _fields) {
+            field.block(toIndex, _passable);
+        }
+    }
+}
+
+void DistanceFields::mine_taken(const Position& mine, const int& from_hero_index, const int& to_hero_index) {
+    int index = _getIndex(mine);
+
+    _fields[(from_hero_index < 0) ? NEUTRAL_MINES : HERO1_MINES + from_hero_index].removeSource(index, _passable);
+    _fields[(to_hero_index < 0) ? NEUTRAL_MINES : HERO1_MINES + to_hero_index].addSource(index, _passable);
+}
+
+bool DistanceFields::supports(const std::vector<Tile>& goalTypes) {
+    return !goalTypes.empty() && _getGoalMask(goalTypes) >= 0;
+}
+
+int DistanceFields::getDistance(const Position& start, const std::vector<Tile>& goalTypes) const {
+    int value;
+    _getBestNeighbour(start, _getGoalMask(goalTypes), value);
+
+    return (value == DistanceField::UNREACHABLE) ? -1 : value + 1;
+}
+
+Direction DistanceFields::getDirection(const Position& start, const std::vector<Tile>& goalTypes) const {
+    int value;
+    int neighbour = _getBestNeighbour(start, _getGoalMask(goalTypes), value);
+
+    return (neighbour < 0) ? STAY : posDiffDirections[neighbour];
+}
+
+// Walks down the field, every step lowers the distance by one until a goal (0) is reached
+template<typename Visitor>
+void DistanceFields::_walk(const Position& start, int goalMask, const Visitor& visitor) const {
+    Position current = start;
+
+    while(true) {
+        int value;
+        int neighbour = _getBestNeighbour(current, goalMask, value);
+        if(neighbour < 0) {
+            break;
+        }
+
+        current = Position(current.x + posDiffs[neighbour][0], current.y + posDiffs[neighbour][1]);
+        visitor(current);
+
+        if(value == 0) {
+            break;
+        }
+    }
+}
+
+DistanceFields::PathType DistanceFields::getPath(const Position& start, const std::vector<Tile>& goalTypes) const {
+    PathType result;
+
+    _walk(start, _getGoalMask(goalTypes), [&](const Position& position) {
+        result.push_back(position);
+    });
+
+    return result;
+}
+
+Position DistanceFields::getGoal(const Position& start, const std::vector<Tile>& goalTypes, std::vector<Position>* path) const {
+    Position goal;
+
+    if(path) {
+        path->clear();
+    }
+
+    _walk(start, _getGoalMask(goalTypes), [&](const Position& position) {
+        goal = position;
+        if(path) {
+            path->push_back(position);
+        }
+    });
+
+    return goal;
+}
+
+int DistanceFields::_getGoalMask(const std::vector<Tile>& goalTypes) {
+    int goalMask = 0;
+
+    for(Tile t : goalTypes) {
+        switch(t) {
+            case TAVERN: goalMask |= (1 << TAVERNS); break;
+            case MINE: goalMask |= (1 << NEUTRAL_MINES); break;
+            case MINE1: goalMask |= (1 << HERO1_MINES); break;
+            case MINE2: goalMask |= (1 << HERO2_MINES); break;
+            case MINE3: goalMask |= (1 << HERO3_MINES); break;
+            case MINE4: goalMask |= (1 << HERO4_MINES); break;
+            default: return -1;
+        }
+    }
+
+    return goalMask;
+}
+
+int DistanceFields::_getIndex(const Position& position) const {
+    if(position.x < 0 || position.y < 0 || position.x >= _width || position.y >= _height) {
+        return -1;
+    }
+
+    return position.x * _height + position.y;
+}
+
+int DistanceFields::_getValue(int index, int goalMask) const {
+    int result = DistanceField::UNREACHABLE;
+
+    for(int goal = 0; goal < GOALS_COUNT; ++goal) {
+        if(goalMask & (1 << goal)) {
+            int value = _fields[goal].getValue(index);
+            if(value != DistanceField::UNREACHABLE && (result == DistanceField::UNREACHABLE || value < result)) {
+                result = value;
+            }
+        }
+    }
+
+    return result;
+}
+
+int DistanceFields::_getBestNeighbour(const Position& position, int goalMask, int& value) const {
+    int result = -1;
+    value = DistanceField::UNREACHABLE;
+
+    for(int neighbour = 0; neighbour < 4; ++neighbour) {
+        int index = _getIndex(Position(position.x + posDiffs[neighbour][0], position.y + posDiffs[neighbour][1]));
+        if(index < 0) {
+            continue;
+        }
+
+        int neighbourValue = _getValue(index, goalMask);
+        if(neighbourValue != DistanceField::UNREACHABLE && (value == DistanceField::UNREACHABLE || neighbourValue < value)) {
+            value = neighbourValue;
+            result = neighbour;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,123 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef DISTANCEFIELD_H_INCLUDED
+#define DISTANCEFIELD_H_INCLUDED
+
+#include "state.h"
+#include "utils.h"
+#include "MapIndex.h"
+#include "Bitboard.h"
+
+#include <list>
+#include <vector>
+
+/**
+ * Multi-source BFS distances ("Dijkstra map") from every cell to the nearest goal cell.
+ *
+ * Goals have distance 0, cells that can be walked through (EMPTY, not occupied by a hero)
+ * hold the number of steps to the nearest goal, every other cell is unreachable.
+ */
+class DistanceField {
+    public:
+        static const int UNREACHABLE = -1;
+
+    public:
+        DistanceField();
+
+        // Keeps a pointer to the adjacency table of 'mapIndex', which must outlive the field;
+        // 'passableBoard' holds the cells of 'passable' (empty on boards too big for a bitboard)
+        void compute(const MapIndex& mapIndex, const std::vector<bool>& passable, const Bitboard& passableBoard,
+                     const std::vector<int>& sources);
+
+        int getValue(int index) const { return _values[index]; }
+
+        /*** Dynamic BFS repair, only cells whose distance changes are visited ***/
+        // 'passable' must already describe the board after the change
+        void addSource(int index, const std::vector<bool>& passable);
+        void removeSource(int index, const std::vector<bool>& passable);
+        void block(int index, const std::vector<bool>& passable);
+        void unblock(int index, const std::vector<bool>& passable);
+
+    private:
+        int _getNeighbour(int index, int direction) const { return _adjacency[4 * index + direction]; }
+        void _lower(const std::vector<bool>& passable);
+        void _raise(int index, const std::vector<bool>& passable);
+
+        const int* _adjacency;          // MapIndex neighbours, walls and off-board cells are -1
+        std::vector<int> _values;
+
+        // Scratch buffers of the repairs, kept between updates
+        std::vector<int> _queue;
+        std::vector<std::pair<int, int>> _seeds;
+        std::vector<std::pair<int, int>> _invalidated;
+};
+
+/**
+ * Distance fields of one State for every goal class strategies ask about:
+ * taverns, neutral mines and mines owned by each hero.
+ *
+ * Fields are built once per state and shared by all strategies evaluated in that turn
+ * (see get()); nearest-goal distance and first step are then read from the neighbours of
+ * the start cell instead of running a search.
+ *
+ * Fields attached to a State (State::attach) follow its updates: hero moves and mines
+ * changing hands are repaired locally instead of rebuilding every field.
+ */
+class DistanceFields : public StateObserver {
+    public:
+        typedef std::list<Position> PathType;
+
+    public:
+        DistanceFields(const State& state);
+
+        // Fields attached to 'state' or, for a detached state, fields reused by consecutive calls from
+        // the same thread as long as the state hash doesn't change (valid until a call with another state)
+        static const DistanceFields& get(const State& state);
+
+        /*** StateObserver ***/
+        void hero_moved(const int& hero_index, const Position& from, const Position& to);
+        void mine_taken(const Position& mine, const int& from_hero_index, const int& to_hero_index);
+
+        // True if every goal type has a field (TAVERN, MINE, MINE1-MINE4)
+        static bool supports(const std::vector<Tile>& goalTypes);
+
+        // Same semantics as Path::getPath(state, start, goalTypes): -1 / empty path if no goal is reachable
+        int getDistance(const Position& start, const std::vector<Tile>& goalTypes) const;
+        Direction getDirection(const Position& start, const std::vector<Tile>& goalTypes) const;
+        PathType getPath(const Position& start, const std::vector<Tile>& goalTypes) const;
+        // Goal cell getPath would end at ((-1, -1) if none), its cells are written to 'path' when given
+        Position getGoal(const Position& start, const std::vector<Tile>& goalTypes, std::vector<Position>* path = NULL) const;
+
+    private:
+        enum Goal {
+            TAVERNS,
+            NEUTRAL_MINES,
+            HERO1_MINES,
+            HERO2_MINES,
+            HERO3_MINES,
+            HERO4_MINES,
+            GOALS_COUNT
+        };
+
+        static int _getGoalMask(const std::vector<Tile>& goalTypes);
+
+        int _getIndex(const Position& position) const;
+        int _getValue(int index, int goalMask) const;
+        int _getBestNeighbour(const Position& position, int goalMask, int& value) const;
+        template<typename Visitor>
+        void _walk(const Position& start, int goalMask, const Visitor& visitor) const;
+
+        Hash _hash;
+        MapIndex::Pointer _mapIndex;
+        int _width;
+        int _height;
+        std::vector<bool> _passable;    // EMPTY and not occupied by any hero
+        std::vector<int> _occupancy;    // heroes standing on a cell (two may share a respawn point for a moment)
+        DistanceField _fields[GOALS_COUNT];
+};
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "DistanceTable.h"
+
+#include <map>
+#include <algorithm>
+
+#if defined(OPENMP_FOUND)
+#include <omp.h>
+#endif
+
+const std::uint8_t DistanceTable::UNREACHABLE;
+const int DistanceTable::MAX_CELLS;
+
+DistanceTable::DistanceTable(const Tiles& background, const PositionsSet& blocked) {
+    _width = background.shape()[0];
+    _height = background.shape()[1];
+
+    const int cells = _width * _height;
+    _rows.assign(cells, -1);
+    _walls.assign(cells, false);
+
+    const bool useBoards = Bitboard::fits(_width, _height);
+    if(useBoards) {
+        _walkableBoard = Bitboard(_width, _height);
+        _reachableBoard = Bitboard(_width, _height);
+    }
+
+    int rowsCount = 0;
+    for(int index = 0; index < cells; ++index) {
+        Position position(index / _height, index % _height);
+        Tile tile = get_tile(background, position);
+        if(tile == EMPTY && blocked.find(position) == blocked.end()) {
+            _rows[index] = rowsCount++;
+        } else if(tile == WOOD) {
+            _walls[index] = true;
+        }
+
+        if(useBoards && _rows[index] >= 0) {
+            _walkableBoard.set(index);
+        }
+        if(useBoards && !_walls[index]) {
+            _reachableBoard.set(index);
+        }
+    }
+
+    _distances.assign(static_cast<std::size_t>(rowsCount) * cells, UNREACHABLE);
+
+#if defined(OPENMP_FOUND)
+    #pragma omp parallel
+#endif
+    {
+        std::vector<int> queue;
+        queue.reserve(cells);
+
+#if defined(OPENMP_FOUND)
+        #pragma omp for schedule(dynamic, 16)
+#endif
+        for(int index = 0; index < cells; ++index) {
+            if(_rows[index] >= 0) {
+                _fillRow(_rows[index], index, queue);
+            }
+        }
+    }
+}
+
+DistanceTable::Pointer DistanceTable::get(const HashedPair<Tiles>& background) {
+    static std::map<Hash, Pointer> tables;
+
+    const Tiles& tiles = background.value;
+    if(static_cast<int>(tiles.num_elements()) > MAX_CELLS) {
+        return Pointer();
+    }
+
+    Pointer result;
+
+#if defined(OPENMP_FOUND)
+    #pragma omp critical(distance_table_cache)
+#endif
+    {
+        Pointer& cached = tables[background.hash];
+        if(!cached) {
+            cached = std::make_shared<DistanceTable>(tiles);
+        }
+        result = cached;
+    }
+
+    return result;
+}
+
+int DistanceTable::getDistance(const Position& from, const Position& to) const {
+    int fromIndex = _getIndex(from);
+    int toIndex = _getIndex(to);
+
+    if(fromIndex < 0 || toIndex < 0) {
+        return -1;
+    }
+    if(fromIndex == toIndex) {
+        return 1;       // as Path: a start that is the goal counts as one cell
+    }
+    if(_rows[fromIndex] >= 0) {
+        return _getRowDistance(_rows[fromIndex], toIndex);
+    }
+
+    // Start cell can't be walked through (occupied) - first step goes to one of its neighbours
+    if(from.next_to(to)) {
+        return 1;
+    }
+
+    static const int posDiffs[4][2] = {
+        {  0, -1 }, {  0,  1 }, { -1,  0 }, {  1,  0 }
+    };
+
+    int result = -1;
+    for(const int* posDiff : posDiffs) {
+        int index = _getIndex(Position(from.x + posDiff[0], from.y + posDiff[1]));
+        if(index < 0 || _rows[index] < 0) {
+            continue;
+        }
+
+        int distance = _getRowDistance(_rows[index], toIndex);
+        if(distance >= 0 && (result < 0 || distance + 1 < result)) {
+            result = distance + 1;
+        }
+    }
+
+    return result;
+}
+
+bool DistanceTable::isPassable(const Position& position) const {
+    int index = _getIndex(position);
+    return index >= 0 && _rows[index] >= 0;
+}
+
+int DistanceTable::getPassableCount() const {
+    return _distances.size() / _rows.size();
+}
+
+int DistanceTable::_getIndex(const Position& position) const {
+    if(position.x < 0 || position.y < 0 || position.x >= _width || position.y >= _height) {
+        return -1;
+    }
+
+    return position.x * _height + position.y;
+}
+
+int DistanceTable::_getRowDistance(int row, int index) const {
+    std::uint8_t distance = _distances[static_cast<std::size_t>(row) * _rows.size() + index];
+    return (distance == UNREACHABLE) ? -1 : distance;
+}
+
+void DistanceTable::_fillRow(int row, int sourceIndex, std::vector<int>& queue) {
+    static const int posDiffs[4][2] = {
+        {  0, -1 }, {  0,  1 }, { -1,  0 }, {  1,  0 }
+    };
+
+    std::uint8_t* distances = &_distances[static_cast<std::size_t>(row) * _rows.size()];
+
+    if(_walkableBoard.getWidth() > 0) {
+        Bitboard source(_width, _height);
+        source.set(sourceIndex);
+
+        Bitboard::expand(_walkableBoard, _reachableBoard, source, [distances](int distance, const Bitboard& ring) {
+            ring.forEach([distances, distance](int index) { distances[index] = distance; });
+        }, UNREACHABLE - 1);
+        return;
+    }
+
+    queue.clear();
+    queue.push_back(sourceIndex);
+    distances[sourceIndex] = 0;
+
+    for(std::size_t head = 0; head < queue.size(); ++head) {
+        int index = queue[head];
+        int distance = distances[index] + 1;
+
+        // Only passable cells are walked through, the rest are reached as path ends
+        if(_rows[index] < 0 || distance >= UNREACHABLE) {
+            continue;
+        }
+
+        int x = index / _height;
+        int y = index % _height;
+        for(const int* posDiff : posDiffs) {
+            int neighbour = _getIndex(Position(x + posDiff[0], y + posDiff[1]));
+            if(neighbour < 0 || _walls[neighbour] || distances[neighbour] != UNREACHABLE) {
+                continue;
+            }
+
+            distances[neighbour] = distance;
+            queue.push_back(neighbour);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef DISTANCETABLE_H_INCLUDED
+#define DISTANCETABLE_H_INCLUDED
+
+#include "tiles.h"
+#include "hashed.h"
+#include "Bitboard.h"
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+/**
+ * All-pairs shortest distances for a map, one BFS from every passable (EMPTY) cell.
+ *
+ * Walls, taverns and mines never change during a game, so the table is computed once
+ * and shared by every game played on the same map (see get()). Distances follow the
+ * Path rules: every cell on the way must be passable, only the last one may be any
+ * tile (tavern, mine, hero). Distances above 254 steps are not stored.
+ */
+class DistanceTable {
+    public:
+        typedef std::shared_ptr<const DistanceTable> Pointer;
+
+        static const std::uint8_t UNREACHABLE = 255;
+
+    public:
+        // Cells from 'blocked' are treated as occupied (e.g. by heroes): they can be
+        // reached but not walked through, same as in SimpleMapAdapter
+        DistanceTable(const Tiles& background, const PositionsSet& blocked = PositionsSet());
+
+        // Table of the hero-free background, cached by background hash;
+        // returns null for boards too big for a full table
+        static Pointer get(const HashedPair<Tiles>& background);
+
+        // Number of steps from 'from' to 'to', -1 if there is no path; same as Path::query(...).distance,
+        // so 'from' == 'to' gives 1
+        int getDistance(const Position& from, const Position& to) const;
+
+        bool isPassable(const Position& position) const;
+        int getPassableCount() const;
+
+        // Largest board (in cells) get() builds a table for
+        static const int MAX_CELLS = 48 * 48;
+
+    private:
+        int _getIndex(const Position& position) const;
+        int _getRowDistance(int row, int index) const;
+        void _fillRow(int row, int sourceIndex, std::vector<int>& queue);
+
+        int _width;
+        int _height;
+        std::vector<int> _rows;             // cell index -> matrix row, -1 for cells that can't be walked through
+        std::vector<bool> _walls;           // cells that can't be reached at all
+        std::vector<std::uint8_t> _distances; // rows * cells
+
+        // Passable and non-wall cells for the bitboard BFS, empty on boards too big for one
+        Bitboard _walkableBoard;
+        Bitboard _reachableBoard;
+};
+
+#endif
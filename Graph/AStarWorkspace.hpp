@@ -0,0 +1,256 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef GRAPH_ASTARWORKSPACE_HPP_INCLUDED
+#define GRAPH_ASTARWORKSPACE_HPP_INCLUDED
+
+#include <vector>
+#include <algorithm>
+
+#include "NodeAdapter.hpp"
+
+
+namespace Graph {
+
+    /**
+     * Reusable memory for flat (cell-indexed) searches on a rectangular grid.
+     *
+     * Cells are indexed as `x * height + y`, so index order matches `operator<` on positions.
+     * Visited flags are generation-stamped: starting a new search only bumps a counter, and
+     * buffers are reallocated only when the board grows. After the first query on a board
+     * no further allocations happen.
+     */
+    template<typename _PositionType, typename _CostType = int>
+    class AStarWorkspace {
+        public:
+            typedef _PositionType                   PositionType;
+            typedef _CostType                       CostType;
+
+            typedef NodeAdapter<PositionType, CostType> NodeAdapterType;
+
+
+        public:
+            AStarWorkspace() : _width(0), _height(0), _generation(0), _heapSize(0), _expansions(0) {
+
+            }
+
+            void resize(int width, int height) {
+                if(width == _width && height == _height) {
+                    return;
+                }
+
+                _width = width;
+                _height = height;
+
+                const std::size_t cells = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+                _openStamp.assign(cells, 0);
+                _closedStamp.assign(cells, 0);
+                _costG.assign(cells, CostType());
+                _costH.assign(cells, CostType());
+                _parent.assign(cells, -1);
+                _heapIndex.assign(cells, -1);
+                _heap.assign(cells, -1);
+                _generation = 0;
+            }
+
+            void clear() {
+                ++_generation;
+                if(_generation == 0) {
+                    // Stamps wrapped around, old marks could be mistaken for fresh ones
+                    std::fill(_openStamp.begin(), _openStamp.end(), 0);
+                    std::fill(_closedStamp.begin(), _closedStamp.end(), 0);
+                    _generation = 1;
+                }
+
+                _heapSize = 0;
+                _expansions = 0;
+            }
+
+            int width() const { return _width; }
+            int height() const { return _height; }
+            int size() const { return _width * _height; }
+
+            // Changes with every clear(), so a caller can tell whether another search ran since its own
+            unsigned int generation() const { return _generation; }
+
+            bool contains(const PositionType& position) const {
+                return position.x >= 0 && position.y >= 0 && position.x < _width && position.y < _height;
+            }
+
+            int indexOf(const PositionType& position) const {
+                return position.x * _height + position.y;
+            }
+
+            PositionType positionOf(int index) const {
+                return PositionType(index / _height, index % _height);
+            }
+
+            bool isOpen(int index) const { return _openStamp[index] == _generation; }
+            bool isClosed(int index) const { return _closedStamp[index] == _generation; }
+            void close(int index) { _closedStamp[index] = _generation; ++_expansions; }
+
+            CostType g(int index) const { return _costG[index]; }
+            CostType h(int index) const { return _costH[index]; }
+            CostType f(int index) const { return _costG[index] + _costH[index]; }
+            int parent(int index) const { return _parent[index]; }
+
+            void set(int index, CostType costG, CostType costH, int parentIndex) {
+                _costG[index] = costG;
+                _costH[index] = costH;
+                _parent[index] = parentIndex;
+            }
+
+            void setParent(int index, int parentIndex) { _parent[index] = parentIndex; }
+
+            // Marks a cell open without the heap, for searches keeping their own open list (BucketSearch)
+            void open(int index) { _openStamp[index] = _generation; }
+
+            /*** Open list: binary heap of cell indices ordered by (f, h, index) ***/
+            bool empty() const { return _heapSize == 0; }
+
+            void push(int index) {
+                _openStamp[index] = _generation;
+                _heap[_heapSize] = index;
+                _heapIndex[index] = _heapSize;
+                ++_heapSize;
+                _siftUp(_heapSize - 1);
+            }
+
+            // Restores heap order after g(index) was lowered for an already open cell
+            void decrease(int index) {
+                _siftUp(_heapIndex[index]);
+            }
+
+            int pop() {
+                int top = _heap[0];
+
+                --_heapSize;
+                if(_heapSize > 0) {
+                    _heap[0] = _heap[_heapSize];
+                    _heapIndex[_heap[0]] = 0;
+                    _siftDown(0);
+                }
+
+                _openStamp[top] = 0;
+                return top;
+            }
+
+            // Positions from 'start' (excluded unless it is the goal itself) to 'goal', empty for goal -1
+            template<typename PathType>
+            PathType getPath(int goalIndex) const {
+                PathType resultPath;
+
+                if(goalIndex < 0) {
+                    return resultPath;
+                }
+
+                resultPath.push_front(positionOf(goalIndex));
+                for(int index = _parent[goalIndex]; index >= 0 && _parent[index] >= 0; index = _parent[index]) {
+                    resultPath.push_front(positionOf(index));
+                }
+
+                return resultPath;
+            }
+
+            // Index of the first cell after the start on the path to 'goalIndex' (the goal itself when the
+            // start is the goal); 'length' gets the number of cells getPath would return
+            int getFirstStep(int goalIndex, int& length) const {
+                int first = goalIndex;
+
+                length = 1;
+                for(int index = _parent[goalIndex]; index >= 0 && _parent[index] >= 0; index = _parent[index]) {
+                    first = index;
+                    ++length;
+                }
+
+                return first;
+            }
+
+            // Same cells as getPath, written into a caller-owned vector
+            void getPath(int goalIndex, std::vector<PositionType>& path) const {
+                int length = 0;
+
+                path.clear();
+                if(goalIndex < 0) {
+                    return;
+                }
+
+                getFirstStep(goalIndex, length);
+                path.resize(length);
+                for(int index = goalIndex; length > 0; index = _parent[index]) {
+                    path[--length] = positionOf(index);
+                }
+            }
+
+            // Scratch buffer for GraphAdapter::getNeighboursOf, keeps its capacity between queries
+            std::vector<NodeAdapterType>& neighbours() { return _neighbours; }
+
+            // Number of nodes closed since the last clear()
+            unsigned int expansions() const { return _expansions; }
+
+        private:
+            bool _less(int lhs, int rhs) const {
+                CostType fl = f(lhs), fr = f(rhs);
+                return (fl < fr || (fl == fr && (_costH[lhs] < _costH[rhs] || (_costH[lhs] == _costH[rhs] && lhs < rhs))));
+            }
+
+            void _siftUp(int slot) {
+                int index = _heap[slot];
+                while(slot > 0) {
+                    int parentSlot = (slot - 1) / 2;
+                    if(!_less(index, _heap[parentSlot])) {
+                        break;
+                    }
+                    _heap[slot] = _heap[parentSlot];
+                    _heapIndex[_heap[slot]] = slot;
+                    slot = parentSlot;
+                }
+                _heap[slot] = index;
+                _heapIndex[index] = slot;
+            }
+
+            void _siftDown(int slot) {
+                int index = _heap[slot];
+                while(true) {
+                    int child = 2 * slot + 1;
+                    if(child >= _heapSize) {
+                        break;
+                    }
+                    if(child + 1 < _heapSize && _less(_heap[child + 1], _heap[child])) {
+                        ++child;
+                    }
+                    if(!_less(_heap[child], index)) {
+                        break;
+                    }
+                    _heap[slot] = _heap[child];
+                    _heapIndex[_heap[slot]] = slot;
+                    slot = child;
+                }
+                _heap[slot] = index;
+                _heapIndex[index] = slot;
+            }
+
+            int _width;
+            int _height;
+            unsigned int _generation;
+
+            std::vector<unsigned int> _openStamp;
+            std::vector<unsigned int> _closedStamp;
+            std::vector<CostType> _costG;
+            std::vector<CostType> _costH;
+            std::vector<int> _parent;
+
+            std::vector<int> _heap;
+            std::vector<int> _heapIndex;
+            int _heapSize;
+
+            std::vector<NodeAdapterType> _neighbours;
+            unsigned int _expansions;
+    };
+
+}
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef GRAPH_BIDIRECTIONALSEARCH_HPP_INCLUDED
+#define GRAPH_BIDIRECTIONALSEARCH_HPP_INCLUDED
+
+#include <list>
+#include <vector>
+#include <climits>
+#include <algorithm>
+
+#include "AStarWorkspace.hpp"
+
+
+namespace Graph {
+
+    /**
+     * The two BFS trees of BidirectionalSearch (side 0 grows from the start, 1 from the goal).
+     *
+     * Kept by the caller between searches, like the workspace; sized by the first search on a
+     * board and generation-stamped, so a new search forgets both trees without clearing them.
+     */
+    class BidirectionalMemory {
+        public:
+            BidirectionalMemory() : _cells(0), _generation(0) {
+
+            }
+
+            // Forgets the trees of the previous search on a board of 'cells' cells
+            void reset(int cells) {
+                if(cells != _cells) {
+                    _cells = cells;
+                    for(int side = 0; side < 2; ++side) {
+                        _reachedStamp[side].assign(cells, 0);
+                        _reachedFrom[side].assign(cells, -1);
+                        _reachedDepth[side].assign(cells, 0);
+                        _queue[side].reserve(cells);
+                    }
+                    _generation = 0;
+                }
+
+                ++_generation;
+                if(_generation == 0) {
+                    // Stamps wrapped around, old marks could be mistaken for fresh ones
+                    std::fill(_reachedStamp[0].begin(), _reachedStamp[0].end(), 0);
+                    std::fill(_reachedStamp[1].begin(), _reachedStamp[1].end(), 0);
+                    _generation = 1;
+                }
+
+                _queue[0].clear();
+                _queue[1].clear();
+            }
+
+            bool isReached(int side, int index) const { return _reachedStamp[side][index] == _generation; }
+            // Previous cell on the way back to the root of the side, -1 for the root
+            int reachedFrom(int side, int index) const { return _reachedFrom[side][index]; }
+            int reachedDepth(int side, int index) const { return _reachedDepth[side][index]; }
+
+            void reach(int side, int index, int fromIndex, int depth) {
+                _reachedStamp[side][index] = _generation;
+                _reachedFrom[side][index] = fromIndex;
+                _reachedDepth[side][index] = depth;
+            }
+
+            // BFS queue of a side, keeps its capacity between searches
+            std::vector<int>& queue(int side) { return _queue[side]; }
+
+        private:
+            int _cells;
+            unsigned int _generation;
+
+            std::vector<unsigned int> _reachedStamp[2];
+            std::vector<int> _reachedFrom[2];
+            std::vector<int> _reachedDepth[2];
+            std::vector<int> _queue[2];
+    };
+
+    /**
+     * Bidirectional breadth-first search for a single goal cell with uniform step cost.
+     *
+     * Two BFS trees grow from the start and from the goal, always by one whole layer of the
+     * smaller frontier, until they touch; roughly two balls of half the radius are visited
+     * instead of one of the full radius.
+     *
+     * Takes the same adapters as PolicyAStar (the heuristic is not used). Start and goal are
+     * only path ends: neither is walked through, so it doesn't matter that the start (a hero)
+     * or the goal (a hero, tavern or mine) isn't a walkable tile. Cells in between must be
+     * available; the goal itself is always reachable, as isAvailable(goal) is expected to say.
+     */
+    template<typename _AdapterType>
+    class BidirectionalSearch {
+        public:
+            typedef _AdapterType                            AdapterType;
+            typedef typename AdapterType::PositionType      PositionType;
+            typedef typename AdapterType::CostType          CostType;
+            typedef std::list<PositionType>                 PathType;
+
+            typedef AStarWorkspace<PositionType, CostType>  WorkspaceType;
+
+
+        public:
+            BidirectionalSearch(WorkspaceType& workspace, BidirectionalMemory& memory) : _workspace(workspace), _memory(memory) {
+
+            }
+
+            PathType getPath(const AdapterType& adapter, const PositionType& start, const PositionType& goal) const {
+                return _workspace.template getPath<PathType>(search(adapter, start, goal));
+            }
+
+            // Runs the search and returns workspace index of the goal or -1 if there is no path; parents
+            // (of the whole path, as if it was found by PolicyAStar) stay in the workspace until its next search
+            int search(const AdapterType& adapter, const PositionType& start, const PositionType& goal) const {
+                WorkspaceType& ws = _workspace;
+
+                ws.clear();
+                if(!ws.contains(start) || !ws.contains(goal)) {
+                    return -1;
+                }
+
+                const int startIndex = ws.indexOf(start);
+                const int goalIndex = ws.indexOf(goal);
+
+                ws.set(startIndex, CostType(), CostType(), -1);
+                if(startIndex == goalIndex) {
+                    return startIndex;
+                }
+
+                BidirectionalMemory& trees = _memory;
+                std::size_t heads[2] = { 0, 0 };
+                trees.reset(ws.size());
+                trees.reach(0, startIndex, -1, 0);
+                trees.reach(1, goalIndex, -1, 0);
+                trees.queue(0).push_back(startIndex);
+                trees.queue(1).push_back(goalIndex);
+
+                // Best meeting found so far: edge between 'meetFrom' (reached from the start) and 'meetTo'
+                int meetFrom = -1, meetTo = -1, meetLength = INT_MAX;
+
+                while(heads[0] < trees.queue(0).size() && heads[1] < trees.queue(1).size()) {
+                    const int side = (trees.queue(0).size() - heads[0] <= trees.queue(1).size() - heads[1]) ? 0 : 1;
+                    const int other = 1 - side;
+                    std::vector<int>& queue = trees.queue(side);
+
+                    // Whole layer at once: the shortest path is among the meetings found in the first layer that meets
+                    const std::size_t layerEnd = queue.size();
+                    for(std::size_t& head = heads[side]; head < layerEnd; ++head) {
+                        const int current = queue[head];
+                        const int depth = trees.reachedDepth(side, current) + 1;
+
+                        ws.close(current);
+                        adapter.forEachNeighbour(ws.positionOf(current), [&](const PositionType& neighbour) {
+                            if(!ws.contains(neighbour)) {
+                                return;
+                            }
+
+                            int index = ws.indexOf(neighbour);
+                            if(trees.isReached(other, index)) {
+                                if(depth + trees.reachedDepth(other, index) < meetLength) {
+                                    meetLength = depth + trees.reachedDepth(other, index);
+                                    meetFrom = (side == 0) ? current : index;
+                                    meetTo = (side == 0) ? index : current;
+                                }
+                                return;
+                            }
+
+                            if(trees.isReached(side, index) || !adapter.isAvailable(neighbour)) {
+                                return;
+                            }
+
+                            trees.reach(side, index, current, depth);
+                            queue.push_back(index);
+                        });
+                    }
+
+                    if(meetFrom >= 0) {
+                        _link(startIndex, meetFrom, meetTo);
+                        return goalIndex;
+                    }
+                }
+
+                return -1;
+            }
+
+            unsigned int getExpansions() const {
+                return _workspace.expansions();
+            }
+
+        private:
+            // Writes the path start -> meetFrom -> meetTo -> goal as workspace parents
+            void _link(int startIndex, int meetFrom, int meetTo) const {
+                WorkspaceType& ws = _workspace;
+
+                for(int index = meetFrom; index != startIndex; index = _memory.reachedFrom(0, index)) {
+                    ws.setParent(index, _memory.reachedFrom(0, index));
+                }
+
+                int previous = meetFrom;
+                for(int index = meetTo; index >= 0; index = _memory.reachedFrom(1, index)) {
+                    ws.setParent(index, previous);
+                    previous = index;
+                }
+            }
+
+            WorkspaceType& _workspace;
+            BidirectionalMemory& _memory;
+    };
+
+}
+
+#endif
@@ -0,0 +1,215 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef GRAPH_BUCKETSEARCH_HPP_INCLUDED
+#define GRAPH_BUCKETSEARCH_HPP_INCLUDED
+
+#include <list>
+#include <vector>
+
+#include "AStarWorkspace.hpp"
+#include "SearchLimits.hpp"
+
+
+namespace Graph {
+
+    /**
+     * Bucket ring of BucketSearch and where a cancelled search stopped in it.
+     *
+     * Kept by the caller between searches, like the workspace, so buckets keep their capacity
+     * and resume() finds the ring as the cancelled search left it.
+     */
+    class BucketMemory {
+        public:
+            BucketMemory() : _suspendedCost(0), _suspendedPending(0) {
+
+            }
+
+            // Prepares a ring of 'count' empty buckets; only those filled by the previous search need emptying
+            void reset(int count) {
+                for(int slot : _filledBuckets) {
+                    _buckets[slot].clear();
+                }
+                _filledBuckets.clear();
+
+                if(_buckets.size() < static_cast<std::size_t>(count)) {
+                    _buckets.resize(count);
+                }
+            }
+
+            void push(int slot, int index) {
+                if(_buckets[slot].empty()) {
+                    _filledBuckets.push_back(slot);
+                }
+                _buckets[slot].push_back(index);
+            }
+
+            std::vector<int>& bucket(int slot) { return _buckets[slot]; }
+
+            // Where a cancelled search stopped: f of the current bucket and entries left in the ring
+            void suspend(int costF, int pending) { _suspendedCost = costF; _suspendedPending = pending; }
+            int suspendedCost() const { return _suspendedCost; }
+            int suspendedPending() const { return _suspendedPending; }
+
+        private:
+            std::vector<std::vector<int>> _buckets;
+            std::vector<int> _filledBuckets;
+            int _suspendedCost;
+            int _suspendedPending;
+    };
+
+    /**
+     * A* for small integer step costs on a bucket queue (Dial's algorithm); with a lower
+     * bound of 0 it is Dijkstra.
+     *
+     * Open cells are kept in a ring of getMaxStepCost() + 2 buckets, one per value of f:
+     * with a consistent bound f never drops along an edge and grows by at most the step
+     * cost plus one, so every open cell fits in the ring. Pushing appends to a bucket and
+     * popping takes from the current one, both O(1). A cell whose cost drops is pushed
+     * again; its old entry is skipped, as the cell is closed by then.
+     *
+     * AdapterType must provide what PolicyAStar needs (the heuristic is not used) and:
+     *      int getStepCost(const PositionType& from, const PositionType& to) const;    // at least 1
+     *      int getMaxStepCost() const;
+     *      int getLowerBound(const PositionType& position) const;  // consistent: drops by at most 1 per step
+     *
+     * GoalType must provide:
+     *      bool isGoal(const PositionType& position) const;
+     */
+    template<typename _AdapterType>
+    class BucketSearch {
+        public:
+            typedef _AdapterType                            AdapterType;
+            typedef typename AdapterType::PositionType      PositionType;
+            typedef typename AdapterType::CostType          CostType;
+            typedef std::list<PositionType>                 PathType;
+
+            typedef AStarWorkspace<PositionType, CostType>  WorkspaceType;
+
+
+        public:
+            BucketSearch(WorkspaceType& workspace, BucketMemory& memory) : _workspace(workspace), _memory(memory) {
+
+            }
+
+            template<typename GoalType>
+            PathType getPath(const AdapterType& adapter, const PositionType& start, const GoalType& goal) const {
+                return _workspace.template getPath<PathType>(search(adapter, start, goal));
+            }
+
+            // Runs the search and returns workspace index of the cheapest goal or -1 if there is no path;
+            // parents and costs (g) stay in the workspace until its next search
+            template<typename GoalType>
+            int search(const AdapterType& adapter, const PositionType& start, const GoalType& goal) const {
+                return search(adapter, start, goal, NoLimits());
+            }
+
+            // Same within the limits (see SearchLimits.hpp), SEARCH_CANCELLED when they cancel the search
+            template<typename GoalType, typename LimitsType>
+            int search(const AdapterType& adapter, const PositionType& start, const GoalType& goal, const LimitsType& limits) const {
+                WorkspaceType& ws = _workspace;
+
+                ws.clear();
+                if(!ws.contains(start)) {
+                    return -1;
+                }
+
+                _memory.reset(adapter.getMaxStepCost() + 2);
+
+                int startIndex = ws.indexOf(start);
+                int costF = adapter.getLowerBound(start);
+                ws.set(startIndex, CostType(), CostType(costF), -1);
+                ws.open(startIndex);
+                _memory.push(costF % (adapter.getMaxStepCost() + 2), startIndex);
+
+                return _run(adapter, goal, limits, costF, 1);
+            }
+
+            // Continues the search that returned SEARCH_CANCELLED, same adapter and goal
+            template<typename GoalType, typename LimitsType>
+            int resume(const AdapterType& adapter, const GoalType& goal, const LimitsType& limits) const {
+                return _run(adapter, goal, limits, _memory.suspendedCost(), _memory.suspendedPending());
+            }
+
+            unsigned int getExpansions() const {
+                return _workspace.expansions();
+            }
+
+        private:
+            // The loop of search() from the bucket of 'costF' with 'pending' entries in the ring
+            template<typename GoalType, typename LimitsType>
+            int _run(const AdapterType& adapter, const GoalType& goal, const LimitsType& limits, int costF, int pending) const {
+                WorkspaceType& ws = _workspace;
+                const int span = adapter.getMaxStepCost() + 2;
+
+                while(pending > 0) {
+                    std::vector<int>& bucket = _memory.bucket(costF % span);
+                    if(bucket.empty()) {
+                        ++costF;
+                        continue;
+                    }
+
+                    if(limits.isBeyond(costF)) {
+                        return -1;
+                    }
+
+                    if(limits.isCancelled(ws.expansions())) {
+                        _memory.suspend(costF, pending);
+                        return SEARCH_CANCELLED;
+                    }
+
+                    int current = bucket.back();
+                    bucket.pop_back();
+                    --pending;
+
+                    if(ws.isClosed(current)) {
+                        continue;
+                    }
+
+                    PositionType currentPosition = ws.positionOf(current);
+                    if(goal.isGoal(currentPosition)) {
+                        return current;
+                    }
+
+                    ws.close(current);
+
+                    const int currentG = static_cast<int>(ws.g(current));
+                    adapter.forEachNeighbour(currentPosition, [&](const PositionType& neighbour) {
+                        if(!ws.contains(neighbour) || !adapter.isAvailable(neighbour)) {
+                            return;
+                        }
+
+                        int index = ws.indexOf(neighbour);
+                        if(ws.isClosed(index)) {
+                            return;
+                        }
+
+                        int costG = currentG + adapter.getStepCost(currentPosition, neighbour);
+                        if(ws.isOpen(index)) {
+                            if(costG >= ws.g(index)) {
+                                return;
+                            }
+                            ws.set(index, CostType(costG), ws.h(index), current);
+                        } else {
+                            ws.set(index, CostType(costG), CostType(adapter.getLowerBound(neighbour)), current);
+                            ws.open(index);
+                        }
+
+                        _memory.push(static_cast<int>(ws.f(index)) % span, index);
+                        ++pending;
+                    });
+                }
+
+                return -1;
+            }
+
+            WorkspaceType& _workspace;
+            BucketMemory& _memory;
+    };
+
+}
+
+#endif
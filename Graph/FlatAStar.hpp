@@ -0,0 +1,129 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef GRAPH_FLATASTAR_HPP_INCLUDED
+#define GRAPH_FLATASTAR_HPP_INCLUDED
+
+#include <list>
+#include <vector>
+#include <functional>
+
+#include "NodeAdapter.hpp"
+#include "GraphAdapter.hpp"
+#include "AStarWorkspace.hpp"
+
+
+namespace Graph {
+
+    /**
+     * A* with the same interface as Graph::AStar, but running on a cell-indexed binary heap
+     * and flat cost/parent arrays kept in an AStarWorkspace. The workspace must be resized
+     * to the board before searching and may be shared by consecutive (not concurrent) queries.
+     */
+    template<typename _MapType, typename _PositionType, typename _CostType = int>
+    class FlatAStar {
+        public:
+            typedef _MapType                        MapType;
+            typedef _PositionType                   PositionType;
+            typedef _CostType                       CostType;
+            typedef std::list<PositionType>         PathType;
+
+            typedef NodeAdapter<PositionType, CostType> NodeAdapterType;
+            typedef GraphAdapter<MapType, PositionType, CostType> GraphAdapterType;
+            typedef AStarWorkspace<PositionType, CostType> WorkspaceType;
+
+
+        public:
+            FlatAStar(WorkspaceType& workspace) : _workspace(workspace) {
+
+            }
+
+            PathType getPath(const GraphAdapterType& graphAdapter, const NodeAdapterType& start, const std::function<bool(const NodeAdapterType&)>& endCondition) const {
+                int goalIndex = _search(graphAdapter, start, endCondition, start, false);
+
+                return _getPath(goalIndex);
+            }
+
+            PathType getPath(const GraphAdapterType& graphAdapter, const NodeAdapterType& start, const NodeAdapterType& goal) const {
+                const PositionType& goalPosition = goal.position;
+                int goalIndex = _search(graphAdapter, start, [&](const NodeAdapterType& node) -> bool {
+                    return node.position == goalPosition;
+                }, goal, true);
+
+                return _getPath(goalIndex);
+            }
+
+            unsigned int getExpansions() const {
+                return _workspace.expansions();
+            }
+
+        private:
+            // Returns workspace index of the reached goal or -1 if no path exists
+            template<typename EndCondition>
+            int _search(const GraphAdapterType& graphAdapter, const NodeAdapterType& start, const EndCondition& endCondition, const NodeAdapterType& goal, bool useGoal) const {
+                WorkspaceType& ws = _workspace;
+                std::vector<NodeAdapterType>& neighbours = ws.neighbours();
+
+                ws.clear();
+                if(!ws.contains(start.position)) {
+                    return -1;
+                }
+
+                int startIndex = ws.indexOf(start.position);
+                ws.set(startIndex, start.g(), start.h(), -1);
+                ws.push(startIndex);
+
+                while(ws.empty() == false) {
+                    int current = ws.pop();
+                    NodeAdapterType currentNode(ws.positionOf(current));
+                    currentNode.g(ws.g(current));
+                    currentNode.h(ws.h(current));
+
+                    if(endCondition(currentNode) == true) {
+                        return current;
+                    }
+
+                    ws.close(current);
+
+                    neighbours.clear();
+                    graphAdapter.getNeighboursOf(currentNode, neighbours);
+                    for(NodeAdapterType& neighbour : neighbours) {
+                        if(!ws.contains(neighbour.position) || !graphAdapter.isAvailable(neighbour.position)) {
+                            continue;
+                        }
+
+                        int index = ws.indexOf(neighbour.position);
+                        if(ws.isClosed(index)) {
+                            continue;
+                        }
+
+                        CostType costG = ws.g(current) + 1;
+                        if(ws.isOpen(index)) {
+                            if(costG < ws.g(index)) {
+                                ws.set(index, costG, ws.h(index), current);
+                                ws.decrease(index);
+                            }
+                        } else {
+                            neighbour.g(costG);
+                            ws.set(index, costG, graphAdapter.getHeuristicCostLeft(neighbour, useGoal ? goal : neighbour), current);
+                            ws.push(index);
+                        }
+                    }
+                }
+
+                return -1;
+            }
+
+            PathType _getPath(int goalIndex) const {
+                return _workspace.template getPath<PathType>(goalIndex);
+            }
+
+            WorkspaceType& _workspace;
+    };
+
+}
+
+#endif
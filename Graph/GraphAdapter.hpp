@@ -42,6 +42,12 @@ namespace Graph {
 
             virtual bool isAvailable(const PositionType& position) const = 0;
             virtual std::vector<NodeAdapterType> getNeighboursOf(const NodeAdapterType& node) const = 0;
+
+            // Appends neighbours to a caller-owned buffer, adapters may override it to avoid allocating
+            virtual void getNeighboursOf(const NodeAdapterType& node, std::vector<NodeAdapterType>& neighbours) const {
+                std::vector<NodeAdapterType> result = getNeighboursOf(node);
+                neighbours.insert(neighbours.end(), result.begin(), result.end());
+            }
             
             virtual CostType getHeuristicCostLeft(const NodeAdapterType& currentNode, const NodeAdapterType& goal) const {
                 (void) currentNode; // unused here
@@ -0,0 +1,294 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef GRAPH_JUMPPOINTSEARCH_HPP_INCLUDED
+#define GRAPH_JUMPPOINTSEARCH_HPP_INCLUDED
+
+#include <list>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+#include "AStarWorkspace.hpp"
+
+
+namespace Graph {
+
+    /**
+     * Per-search memos of JumpPointSearch: availability of cells and results of scans along x.
+     *
+     * Kept by the caller between searches, like the workspace; sized by the first search on a
+     * board and generation-stamped, so a new search forgets them without clearing anything.
+     */
+    class JumpPointMemory {
+        public:
+            JumpPointMemory() : _cells(0), _generation(0) {
+
+            }
+
+            // Forgets the memos of the previous search on a board of 'cells' cells
+            void reset(int cells) {
+                if(cells != _cells) {
+                    _cells = cells;
+                    _knownStamp.assign(cells, 0);
+                    _known.assign(cells, 0);
+                    _scanStamp.assign(2 * cells, 0);
+                    _scanResult.assign(2 * cells, -1);
+                    _generation = 0;
+                }
+
+                ++_generation;
+                if(_generation == 0) {
+                    // Stamps wrapped around, old marks could be mistaken for fresh ones
+                    std::fill(_knownStamp.begin(), _knownStamp.end(), 0);
+                    std::fill(_scanStamp.begin(), _scanStamp.end(), 0);
+                    _generation = 1;
+                }
+            }
+
+            // One flag per cell (availability)
+            bool isKnown(int index) const { return _knownStamp[index] == _generation; }
+            bool known(int index) const { return _known[index] != 0; }
+            void remember(int index, bool flag) { _knownStamp[index] = _generation; _known[index] = flag; }
+
+            // Two scan results per cell (slot = 2 * index + direction)
+            bool hasScan(int slot) const { return _scanStamp[slot] == _generation; }
+            int getScan(int slot) const { return _scanResult[slot]; }
+            void setScan(int slot, int result) { _scanStamp[slot] = _generation; _scanResult[slot] = result; }
+
+            // Scratch buffer for the slots of the running scan
+            std::vector<int>& scanned() { return _scanned; }
+
+        private:
+            int _cells;
+            unsigned int _generation;
+
+            std::vector<unsigned int> _knownStamp;
+            std::vector<unsigned char> _known;
+            std::vector<unsigned int> _scanStamp;
+            std::vector<int> _scanResult;
+            std::vector<int> _scanned;
+    };
+
+    /**
+     * Jump Point Search for 4-connected grids with uniform step cost.
+     *
+     * Straight runs of cells are scanned without touching the open list: a scan stops
+     * only at goals and at cells where a path has to turn (forced neighbours), so long
+     * corridors and open areas cost one expansion per turn instead of one per cell.
+     * Paths are as short as PolicyAStar's (the heuristic must be admissible), but ties
+     * between equally short paths may be broken differently.
+     *
+     * Takes the same adapters and goals as PolicyAStar. Positions must be grid cells
+     * (x, y); forEachNeighbour is not used, neighbours are the four adjacent cells.
+     * Availability is asked (once per cell) during every search, so cells that change
+     * between searches (heroes block the cells they stand on) need no preprocessing.
+     * Goal cells must be available.
+     */
+    template<typename _AdapterType>
+    class JumpPointSearch {
+        public:
+            typedef _AdapterType                            AdapterType;
+            typedef typename AdapterType::PositionType      PositionType;
+            typedef typename AdapterType::CostType          CostType;
+            typedef std::list<PositionType>                 PathType;
+
+            typedef AStarWorkspace<PositionType, CostType>  WorkspaceType;
+
+
+        public:
+            JumpPointSearch(WorkspaceType& workspace, JumpPointMemory& memory) : _workspace(workspace), _memory(memory) {
+
+            }
+
+            template<typename GoalType>
+            PathType getPath(const AdapterType& adapter, const PositionType& start, const GoalType& goal) const {
+                return _workspace.template getPath<PathType>(search(adapter, start, goal));
+            }
+
+            // Runs the search and returns workspace index of the reached goal or -1 if there is no path;
+            // parents (of every cell on the path, not only jump points) stay in the workspace until its next search
+            template<typename GoalType>
+            int search(const AdapterType& adapter, const PositionType& start, const GoalType& goal) const {
+                static const int directions[4][2] = {
+                    {  0, -1 }, {  0,  1 }, { -1,  0 }, {  1,  0 }
+                };
+
+                WorkspaceType& ws = _workspace;
+
+                ws.clear();
+                if(!ws.contains(start)) {
+                    return -1;
+                }
+
+                _memory.reset(ws.size());
+
+                int startIndex = ws.indexOf(start);
+                ws.set(startIndex, CostType(), CostType(), -1);
+                ws.push(startIndex);
+
+                while(ws.empty() == false) {
+                    int current = ws.pop();
+                    PositionType currentPosition = ws.positionOf(current);
+
+                    if(goal.isGoal(currentPosition)) {
+                        _unpack(current);
+                        return current;
+                    }
+
+                    ws.close(current);
+
+                    // Direction we came from; moving straight on, only turns and going ahead make sense
+                    int fromX = 0, fromY = 0;
+                    if(ws.parent(current) >= 0) {
+                        PositionType parentPosition = ws.positionOf(ws.parent(current));
+                        fromX = _sign(currentPosition.x - parentPosition.x);
+                        fromY = _sign(currentPosition.y - parentPosition.y);
+                    }
+
+                    for(const int* direction : directions) {
+                        int dx = direction[0], dy = direction[1];
+                        if((dx != 0 && dx == -fromX) || (dy != 0 && dy == -fromY)) {
+                            continue;
+                        }
+
+                        int jumpPoint = _jump(adapter, goal, PositionType(currentPosition.x + dx, currentPosition.y + dy), dx, dy);
+                        if(jumpPoint < 0 || ws.isClosed(jumpPoint)) {
+                            continue;
+                        }
+
+                        PositionType jumpPosition = ws.positionOf(jumpPoint);
+                        CostType costG = ws.g(current) + std::abs(jumpPosition.x - currentPosition.x) + std::abs(jumpPosition.y - currentPosition.y);
+
+                        if(ws.isOpen(jumpPoint)) {
+                            if(costG < ws.g(jumpPoint)) {
+                                ws.set(jumpPoint, costG, ws.h(jumpPoint), current);
+                                ws.decrease(jumpPoint);
+                            }
+                        } else {
+                            ws.set(jumpPoint, costG, adapter.getHeuristicCostLeft(jumpPosition), current);
+                            ws.push(jumpPoint);
+                        }
+                    }
+                }
+
+                return -1;
+            }
+
+            unsigned int getExpansions() const {
+                return _workspace.expansions();
+            }
+
+        private:
+            static int _sign(int value) {
+                return (value > 0) - (value < 0);
+            }
+
+            // Scans look at the same cells many times, so availability is asked once per cell and search
+            bool _isAvailable(const AdapterType& adapter, const PositionType& position) const {
+                if(!_workspace.contains(position)) {
+                    return false;
+                }
+
+                int index = _workspace.indexOf(position);
+                if(!_memory.isKnown(index)) {
+                    _memory.remember(index, adapter.isAvailable(position));
+                }
+
+                return _memory.known(index);
+            }
+
+            // Scans from 'position' in direction (dx, dy); returns workspace index of the first jump point
+            // (goal or cell with a forced neighbour) or -1 when the scan runs into an unavailable cell
+            template<typename GoalType>
+            int _jump(const AdapterType& adapter, const GoalType& goal, const PositionType& position, int dx, int dy) const {
+                return (dx != 0) ? _jumpAcross(adapter, goal, position, dx) : _jumpAlong(adapter, goal, position, dy);
+            }
+
+            // Scan along x. Its result depends only on the cell and direction, and scans along y ask it for
+            // every cell they pass, so results are memoized for every cell of the scan
+            template<typename GoalType>
+            int _jumpAcross(const AdapterType& adapter, const GoalType& goal, PositionType position, int dx) const {
+                WorkspaceType& ws = _workspace;
+                std::vector<int>& scanned = _memory.scanned();
+                int result = -1;
+
+                scanned.clear();
+                while(_isAvailable(adapter, position)) {
+                    const int x = position.x, y = position.y;
+                    const int index = ws.indexOf(position);
+                    const int slot = 2 * index + (dx > 0);
+
+                    if(_memory.hasScan(slot)) {
+                        result = _memory.getScan(slot);
+                        break;
+                    }
+                    scanned.push_back(slot);
+
+                    if(goal.isGoal(position) ||
+                       (_isAvailable(adapter, PositionType(x, y - 1)) && !_isAvailable(adapter, PositionType(x - dx, y - 1))) ||
+                       (_isAvailable(adapter, PositionType(x, y + 1)) && !_isAvailable(adapter, PositionType(x - dx, y + 1)))) {
+                        result = index;
+                        break;
+                    }
+
+                    position = PositionType(x + dx, y);
+                }
+
+                for(int slot : scanned) {
+                    _memory.setScan(slot, result);
+                }
+
+                return result;
+            }
+
+            // Scan along y, also looking sideways along x so turns into x-corridors are not missed
+            template<typename GoalType>
+            int _jumpAlong(const AdapterType& adapter, const GoalType& goal, PositionType position, int dy) const {
+                while(_isAvailable(adapter, position)) {
+                    const int x = position.x, y = position.y;
+
+                    if(goal.isGoal(position) ||
+                       (_isAvailable(adapter, PositionType(x - 1, y)) && !_isAvailable(adapter, PositionType(x - 1, y - dy))) ||
+                       (_isAvailable(adapter, PositionType(x + 1, y)) && !_isAvailable(adapter, PositionType(x + 1, y - dy))) ||
+                       _jumpAcross(adapter, goal, PositionType(x - 1, y), -1) >= 0 ||
+                       _jumpAcross(adapter, goal, PositionType(x + 1, y), 1) >= 0) {
+                        return _workspace.indexOf(position);
+                    }
+
+                    position = PositionType(x, y + dy);
+                }
+
+                return -1;
+            }
+
+            // Links the cells between consecutive jump points, so the workspace path helpers
+            // see an ordinary cell by cell chain from the goal back to the start
+            void _unpack(int goalIndex) const {
+                WorkspaceType& ws = _workspace;
+
+                for(int index = goalIndex; ws.parent(index) >= 0; ) {
+                    int jumpParent = ws.parent(index);
+                    PositionType position = ws.positionOf(index);
+                    PositionType target = ws.positionOf(jumpParent);
+                    int dx = _sign(target.x - position.x), dy = _sign(target.y - position.y);
+
+                    for(PositionType next(position.x + dx, position.y + dy); ws.indexOf(position) != jumpParent; next = PositionType(next.x + dx, next.y + dy)) {
+                        ws.setParent(ws.indexOf(position), ws.indexOf(next));
+                        position = next;
+                    }
+
+                    index = jumpParent;
+                }
+            }
+
+            WorkspaceType& _workspace;
+            JumpPointMemory& _memory;
+    };
+
+}
+
+#endif
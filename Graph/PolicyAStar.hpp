@@ -0,0 +1,144 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef GRAPH_POLICYASTAR_HPP_INCLUDED
+#define GRAPH_POLICYASTAR_HPP_INCLUDED
+
+#include <list>
+
+#include "AStarWorkspace.hpp"
+#include "SearchLimits.hpp"
+
+
+namespace Graph {
+
+    /**
+     * A* where the graph and the goal are compile-time policies instead of a virtual
+     * GraphAdapter and a std::function end condition. Every callback is statically
+     * dispatched and can be inlined, and neighbours are visited in place, so a search
+     * allocates nothing beyond the AStarWorkspace.
+     *
+     * AdapterType must provide:
+     *      typedef ... PositionType;
+     *      typedef ... CostType;
+     *      bool isAvailable(const PositionType& position) const;
+     *      CostType getHeuristicCostLeft(const PositionType& position) const;
+     *      template<typename Visitor> void forEachNeighbour(const PositionType& position, const Visitor& visitor) const;
+     *
+     * GoalType must provide:
+     *      bool isGoal(const PositionType& position) const;
+     */
+    template<typename _AdapterType>
+    class PolicyAStar {
+        public:
+            typedef _AdapterType                            AdapterType;
+            typedef typename AdapterType::PositionType      PositionType;
+            typedef typename AdapterType::CostType          CostType;
+            typedef std::list<PositionType>                 PathType;
+
+            typedef AStarWorkspace<PositionType, CostType>  WorkspaceType;
+
+
+        public:
+            PolicyAStar(WorkspaceType& workspace) : _workspace(workspace) {
+
+            }
+
+            template<typename GoalType>
+            PathType getPath(const AdapterType& adapter, const PositionType& start, const GoalType& goal) const {
+                return _workspace.template getPath<PathType>(search(adapter, start, goal));
+            }
+
+            // Runs the search and returns workspace index of the reached goal or -1 if there is no path;
+            // parents stay in the workspace until its next search
+            template<typename GoalType>
+            int search(const AdapterType& adapter, const PositionType& start, const GoalType& goal) const {
+                return search(adapter, start, goal, NoLimits());
+            }
+
+            // Same within the limits (see SearchLimits.hpp), SEARCH_CANCELLED when they cancel the search
+            template<typename GoalType, typename LimitsType>
+            int search(const AdapterType& adapter, const PositionType& start, const GoalType& goal, const LimitsType& limits) const {
+                WorkspaceType& ws = _workspace;
+
+                ws.clear();
+                if(!ws.contains(start)) {
+                    return -1;
+                }
+
+                int startIndex = ws.indexOf(start);
+                ws.set(startIndex, CostType(), CostType(), -1);
+                ws.push(startIndex);
+
+                return _run(adapter, goal, limits);
+            }
+
+            // Continues the search that returned SEARCH_CANCELLED, same adapter and goal
+            template<typename GoalType, typename LimitsType>
+            int resume(const AdapterType& adapter, const GoalType& goal, const LimitsType& limits) const {
+                return _run(adapter, goal, limits);
+            }
+
+            unsigned int getExpansions() const {
+                return _workspace.expansions();
+            }
+
+        private:
+            template<typename GoalType, typename LimitsType>
+            int _run(const AdapterType& adapter, const GoalType& goal, const LimitsType& limits) const {
+                WorkspaceType& ws = _workspace;
+
+                while(ws.empty() == false) {
+                    if(limits.isCancelled(ws.expansions())) {
+                        return SEARCH_CANCELLED;
+                    }
+
+                    int current = ws.pop();
+                    PositionType currentPosition = ws.positionOf(current);
+
+                    // Cells come out in order of f, so nothing left is within the bound either
+                    if(limits.isBeyond(ws.f(current))) {
+                        return -1;
+                    }
+
+                    if(goal.isGoal(currentPosition)) {
+                        return current;
+                    }
+
+                    ws.close(current);
+
+                    CostType costG = ws.g(current) + 1;
+                    adapter.forEachNeighbour(currentPosition, [&](const PositionType& neighbour) {
+                        if(!ws.contains(neighbour) || !adapter.isAvailable(neighbour)) {
+                            return;
+                        }
+
+                        int index = ws.indexOf(neighbour);
+                        if(ws.isClosed(index)) {
+                            return;
+                        }
+
+                        if(ws.isOpen(index)) {
+                            if(costG < ws.g(index)) {
+                                ws.set(index, costG, ws.h(index), current);
+                                ws.decrease(index);
+                            }
+                        } else {
+                            ws.set(index, costG, adapter.getHeuristicCostLeft(neighbour), current);
+                            ws.push(index);
+                        }
+                    });
+                }
+
+                return -1;
+            }
+
+            WorkspaceType& _workspace;
+    };
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef GRAPH_POLICYGRAPHADAPTER_HPP_INCLUDED
+#define GRAPH_POLICYGRAPHADAPTER_HPP_INCLUDED
+
+#include <vector>
+
+#include "GraphAdapter.hpp"
+
+
+namespace Graph {
+
+    /**
+     * Exposes a PolicyAStar adapter through the virtual GraphAdapter interface,
+     * so the same map rules can also run on AStar and FlatAStar.
+     */
+    template<typename _PolicyType, typename _GraphType>
+    class PolicyGraphAdapter : public GraphAdapter<_GraphType, typename _PolicyType::PositionType, typename _PolicyType::CostType> {
+        public:
+            typedef _PolicyType                                 PolicyType;
+            typedef _GraphType                                  GraphType;
+            typedef typename PolicyType::PositionType           PositionType;
+            typedef typename PolicyType::CostType               CostType;
+
+            typedef NodeAdapter<PositionType, CostType> NodeAdapterType;
+            typedef GraphAdapter<GraphType, PositionType, CostType> GraphAdapterBaseType;
+
+
+        public:
+            PolicyGraphAdapter(const GraphType& graph, const PolicyType& policy) : GraphAdapterBaseType(graph), _policy(policy), _expansions(0) {
+
+            }
+
+            bool isAvailable(const PositionType& position) const {
+                return _policy.isAvailable(position);
+            }
+
+            std::vector<NodeAdapterType> getNeighboursOf(const NodeAdapterType& node) const {
+                std::vector<NodeAdapterType> neighbours;
+
+                getNeighboursOf(node, neighbours);
+
+                return neighbours;
+            }
+
+            void getNeighboursOf(const NodeAdapterType& node, std::vector<NodeAdapterType>& neighbours) const {
+                ++_expansions;
+                _policy.forEachNeighbour(node.position, [&](const PositionType& neighbour) {
+                    neighbours.push_back(NodeAdapterType(neighbour));
+                });
+            }
+
+            CostType getHeuristicCostLeft(const NodeAdapterType& currentNode, const NodeAdapterType&) const {
+                return _policy.getHeuristicCostLeft(currentNode.position);
+            }
+
+            // Number of nodes expanded through this adapter
+            unsigned int getExpansions() const {
+                return _expansions;
+            }
+
+        private:
+            const PolicyType& _policy;
+            mutable unsigned int _expansions;
+    };
+
+}
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef GRAPH_SEARCHLIMITS_HPP_INCLUDED
+#define GRAPH_SEARCHLIMITS_HPP_INCLUDED
+
+
+namespace Graph {
+
+    // Returned by searches stopped by LimitsType::isCancelled; they can be resumed
+    static const int SEARCH_CANCELLED = -2;
+
+    /**
+     * Limits of PolicyAStar and BucketSearch runs, a compile-time policy like the adapters.
+     *
+     * LimitsType must provide:
+     *      bool isBeyond(double costF) const;              // no path costing costF or more is wanted
+     *      bool isCancelled(unsigned int expansions) const;  // checked before every expansion
+     *
+     * A search giving up on the bound returns -1 (no path within it). A cancelled one returns
+     * SEARCH_CANCELLED and leaves its open list in the workspace (BucketSearch: in its
+     * BucketMemory), so resume() continues it as long as no other search ran on the workspace
+     * in between.
+     */
+    struct NoLimits {
+        bool isBeyond(double) const { return false; }
+        bool isCancelled(unsigned int) const { return false; }
+    };
+
+}
+
+#endif
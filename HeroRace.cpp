@@ -0,0 +1,159 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "HeroRace.h"
+
+#include <memory>
+#include <climits>
+#include <algorithm>
+
+const int HeroRace::UNREACHABLE;
+
+HeroRace::HeroRace(const State& state) {
+    const MapIndex& mapIndex = *state.get_map_index();
+    _width = mapIndex.getWidth();
+    _height = mapIndex.getHeight();
+    _firstHero = state.next_hero_index;
+    _mines = mapIndex.getMines();
+
+    const int cells = _width * _height;
+    _distances.assign(4 * cells, UNREACHABLE);
+    _owners.assign(cells, -1);
+    std::fill(_territory, _territory + 4, 0);
+
+    std::vector<bool> occupied(cells, false);
+    for(int i = 0; i < 4; ++i) {
+        occupied[mapIndex.getIndex(state.heroes[i].position)] = true;
+    }
+
+    // Entries are cell * 4 + hero. Seeded in turn order, so the FIFO order of every BFS layer
+    // is the turn order too and the first entry popped for a cell is the hero that gets there first
+    std::vector<int> queue;
+    queue.reserve(4 * cells);
+    for(int order = 0; order < 4; ++order) {
+        int hero = (_firstHero + order) % 4;
+        int entry = 4 * mapIndex.getIndex(state.heroes[hero].position) + hero;
+
+        _distances[entry] = 0;
+        queue.push_back(entry);
+    }
+
+    for(std::size_t head = 0; head < queue.size(); ++head) {
+        const int entry = queue[head];
+        const int index = entry / 4, hero = entry % 4;
+        const int distance = _distances[entry];
+
+        if(_owners[index] < 0) {
+            _owners[index] = hero;
+            ++_territory[hero];
+        }
+
+        // Heroes walk from their own cell, but not through other heroes, taverns and mines
+        if(distance > 0 && (!mapIndex.isPassable(index) || occupied[index])) {
+            continue;
+        }
+
+        const int* neighbours = mapIndex.getNeighbours(index);
+        for(int direction = 0; direction < 4; ++direction) {
+            if(neighbours[direction] < 0) {
+                continue;
+            }
+
+            int next = 4 * neighbours[direction] + hero;
+            if(_distances[next] == UNREACHABLE) {
+                _distances[next] = distance + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+const HeroRace& HeroRace::get(const State& state) {
+    static thread_local Hash hash = 0;
+    static thread_local std::unique_ptr<HeroRace> race;
+
+    Hash stateHash = hash_value(state);
+    if(!race || stateHash != hash) {
+        race.reset(new HeroRace(state));
+        hash = stateHash;
+    }
+
+    return *race;
+}
+
+int HeroRace::getDistance(int heroIndex, const Position& position) const {
+    int index = _getIndex(position);
+
+    return (index < 0) ? UNREACHABLE : _distances[4 * index + heroIndex];
+}
+
+int HeroRace::getDistance(int heroIndex, const std::vector<Position>& targets) const {
+    int result = UNREACHABLE;
+
+    for(const Position& target : targets) {
+        int distance = getDistance(heroIndex, target);
+        if(distance != UNREACHABLE && (result == UNREACHABLE || distance < result)) {
+            result = distance;
+        }
+    }
+
+    return result;
+}
+
+int HeroRace::getArrival(int heroIndex, const Position& position) const {
+    int distance = getDistance(heroIndex, position);
+
+    return (distance == UNREACHABLE) ? UNREACHABLE : 4 * distance + _getOrder(heroIndex);
+}
+
+bool HeroRace::isFirst(int heroIndex, int otherIndex, const Position& position) const {
+    int arrival = getArrival(heroIndex, position);
+    int otherArrival = getArrival(otherIndex, position);
+
+    return arrival != UNREACHABLE && (otherArrival == UNREACHABLE || arrival < otherArrival);
+}
+
+int HeroRace::getOwner(const Position& position) const {
+    int index = _getIndex(position);
+
+    return (index < 0) ? -1 : _owners[index];
+}
+
+std::vector<Position> HeroRace::getContestedMines(int margin) const {
+    std::vector<Position> result;
+
+    for(const Position& mine : _mines) {
+        int first = INT_MAX, second = INT_MAX;
+
+        for(int hero = 0; hero < 4; ++hero) {
+            int distance = getDistance(hero, mine);
+            if(distance == UNREACHABLE) {
+                continue;
+            }
+
+            if(distance < first) {
+                second = first;
+                first = distance;
+            } else if(distance < second) {
+                second = distance;
+            }
+        }
+
+        if(second != INT_MAX && second - first <= margin) {
+            result.push_back(mine);
+        }
+    }
+
+    return result;
+}
+
+int HeroRace::_getIndex(const Position& position) const {
+    if(position.x < 0 || position.y < 0 || position.x >= _width || position.y >= _height) {
+        return -1;
+    }
+
+    return position.x * _height + position.y;
+}
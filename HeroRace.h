@@ -0,0 +1,69 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef HERORACE_H_INCLUDED
+#define HERORACE_H_INCLUDED
+
+#include "state.h"
+
+#include <vector>
+
+/**
+ * Which hero gets to every cell first: the board split into territories (a Voronoi
+ * partition by path length) and the step count of every hero to every cell.
+ *
+ * One BFS from all four heroes at once, processed in order of (steps, turn order), where
+ * the hero of next_hero_index moves first. Distances follow the Path rules (only EMPTY
+ * cells not occupied by a hero are walked through, the last cell may be any tile), so
+ * they match Path::getDistance from the hero position. A hero arrives at a cell after
+ * 4 * steps + turn order moves of the game, which settles ties between equal distances.
+ *
+ * Built once per state (see get()), so questions like "do I get to that mine before
+ * him" cost a lookup instead of a search per hero.
+ */
+class HeroRace {
+    public:
+        static const int UNREACHABLE = -1;
+
+    public:
+        HeroRace(const State& state);
+
+        // Race of 'state', shared by every caller of the calling thread as long as the state
+        // hash doesn't change (valid until a call with another state)
+        static const HeroRace& get(const State& state);
+
+        // Steps of the hero to 'position' or UNREACHABLE (also for positions outside the board)
+        int getDistance(int heroIndex, const Position& position) const;
+        // Steps to the nearest of 'targets', UNREACHABLE if none can be reached
+        int getDistance(int heroIndex, const std::vector<Position>& targets) const;
+        // Moves of the game (every hero's) until the hero gets to 'position', UNREACHABLE if it can't
+        int getArrival(int heroIndex, const Position& position) const;
+
+        // True if 'heroIndex' gets to 'position' and does so before 'otherIndex' (who may not get there at all)
+        bool isFirst(int heroIndex, int otherIndex, const Position& position) const;
+
+        // Hero first to get to 'position', -1 if nobody can
+        int getOwner(const Position& position) const;
+        // Number of cells the hero gets to first (its own cell included)
+        int getTerritory(int heroIndex) const { return _territory[heroIndex]; }
+
+        // Mines the two first heroes get to within 'margin' steps of each other
+        std::vector<Position> getContestedMines(int margin) const;
+
+    private:
+        int _getIndex(const Position& position) const;
+        int _getOrder(int heroIndex) const { return (heroIndex - _firstHero + 4) % 4; }
+
+        int _width;
+        int _height;
+        int _firstHero;                 // next_hero_index of the state
+        std::vector<Position> _mines;
+        std::vector<int> _distances;    // cells * 4, heroes of one cell side by side
+        std::vector<int> _owners;       // cell index -> hero first to get there, -1 if nobody can
+        int _territory[4];
+};
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "LandmarkTable.h"
+#include "MapIndex.h"
+
+const int LandmarkTable::MAX_COUNT;
+const int LandmarkTable::DEFAULT_COUNT;
+const std::uint16_t LandmarkTable::UNREACHABLE;
+
+LandmarkTable::LandmarkTable() {
+
+}
+
+void LandmarkTable::compute(const MapIndex& mapIndex, int count) {
+    const int cells = mapIndex.getWidth() * mapIndex.getHeight();
+    count = std::min(count, static_cast<int>(MAX_COUNT));
+
+    std::vector<std::vector<std::uint16_t>> rows;
+    std::vector<int> queue;
+    queue.reserve(cells);
+
+    // Farthest point selection: start from the cell farthest from an arbitrary one, then
+    // repeatedly add the cell farthest from every landmark chosen so far
+    int next = -1;
+    for(int index = 0; index < cells && next < 0; ++index) {
+        if(mapIndex.isPassable(index)) {
+            next = index;
+        }
+    }
+
+    std::vector<std::uint16_t> row;
+    if(next >= 0) {
+        _fill(mapIndex, next, row, queue);
+        for(int index = 0; index < cells; ++index) {
+            if(mapIndex.isPassable(index) && row[index] != UNREACHABLE && row[index] > row[next]) {
+                next = index;
+            }
+        }
+    }
+
+    _landmarks.clear();
+    std::vector<std::uint16_t> nearest(cells, UNREACHABLE);
+    while(next >= 0 && static_cast<int>(_landmarks.size()) < count) {
+        _landmarks.push_back(next);
+        rows.push_back(std::vector<std::uint16_t>());
+        _fill(mapIndex, next, rows.back(), queue);
+
+        next = -1;
+        for(int index = 0; index < cells; ++index) {
+            nearest[index] = std::min(nearest[index], rows.back()[index]);
+            if(mapIndex.isPassable(index) && nearest[index] != UNREACHABLE && nearest[index] > 0 &&
+               (next < 0 || nearest[index] > nearest[next])) {
+                next = index;
+            }
+        }
+    }
+
+    // Interleave, so a bound reads one short run of memory
+    const int landmarks = _landmarks.size();
+    _distances.assign(static_cast<std::size_t>(cells) * landmarks, UNREACHABLE);
+    _highs.assign(static_cast<std::size_t>(cells) * landmarks, UNREACHABLE);
+
+    for(int landmark = 0; landmark < landmarks; ++landmark) {
+        for(int index = 0; index < cells; ++index) {
+            std::uint16_t distance = rows[landmark][index];
+            std::uint16_t high = distance;
+
+            // Cells that are only path ends are entered from a neighbour at most this far from the landmark
+            if(distance != UNREACHABLE && !mapIndex.isPassable(index)) {
+                int farthest = 0;
+                const int* neighbours = mapIndex.getNeighbours(index);
+                for(int direction = 0; direction < 4; ++direction) {
+                    int neighbour = neighbours[direction];
+                    if(neighbour >= 0 && mapIndex.isPassable(neighbour) && rows[landmark][neighbour] != UNREACHABLE) {
+                        farthest = std::max(farthest, static_cast<int>(rows[landmark][neighbour]));
+                    }
+                }
+                high = farthest - 1;
+            }
+
+            _distances[static_cast<std::size_t>(index) * landmarks + landmark] = distance;
+            _highs[static_cast<std::size_t>(index) * landmarks + landmark] = high;
+        }
+    }
+}
+
+LandmarkTable::Target LandmarkTable::getTarget(int goalIndex) const {
+    Target target;
+    target.count = (goalIndex < 0) ? 0 : _landmarks.size();
+
+    for(int landmark = 0; landmark < target.count; ++landmark) {
+        std::size_t slot = static_cast<std::size_t>(goalIndex) * target.count + landmark;
+        bool reachable = (_distances[slot] != UNREACHABLE);
+
+        target.low[landmark] = reachable ? _distances[slot] : -1;
+        target.high[landmark] = reachable ? _highs[slot] : -1;
+    }
+
+    return target;
+}
+
+// BFS from 'source' following the Path rules: only passable cells are walked through
+void LandmarkTable::_fill(const MapIndex& mapIndex, int source, std::vector<std::uint16_t>& row, std::vector<int>& queue) {
+    row.assign(mapIndex.getWidth() * mapIndex.getHeight(), UNREACHABLE);
+
+    queue.clear();
+    queue.push_back(source);
+    row[source] = 0;
+
+    for(std::size_t head = 0; head < queue.size(); ++head) {
+        int index = queue[head];
+        if(index != source && !mapIndex.isPassable(index)) {
+            continue;
+        }
+
+        const int* neighbours = mapIndex.getNeighbours(index);
+        for(int direction = 0; direction < 4; ++direction) {
+            int neighbour = neighbours[direction];
+            if(neighbour >= 0 && row[neighbour] == UNREACHABLE) {
+                row[neighbour] = row[index] + 1;
+                queue.push_back(neighbour);
+            }
+        }
+    }
+}
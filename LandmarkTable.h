@@ -0,0 +1,82 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef LANDMARKTABLE_H_INCLUDED
+#define LANDMARKTABLE_H_INCLUDED
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+class MapIndex;
+
+/**
+ * Landmark (ALT) lower bounds on path lengths.
+ *
+ * BFS distances from a few landmark cells, chosen far from each other, give by the
+ * triangle inequality a lower bound on the distance between any two cells - a much
+ * tighter A* heuristic than straight-line distance on maps full of walls. Only
+ * count * cells distances are stored, instead of cells * cells for all pairs.
+ *
+ * Distances follow the Path rules on the hero-free map (only EMPTY cells are walked
+ * through, the last cell may be any tile). Heroes can only make paths longer, so the
+ * bounds stay admissible during the whole game and the table is built once per map.
+ */
+class LandmarkTable {
+    public:
+        static const int MAX_COUNT = 16;
+        static const int DEFAULT_COUNT = 8;
+        static const std::uint16_t UNREACHABLE = 0xFFFF;
+
+        // Per-landmark bounds of one goal cell, prepared once per query (see getTarget())
+        struct Target {
+            int count;
+            int low[MAX_COUNT];     // distance from the landmark to the goal, -1 to skip the landmark
+            int high[MAX_COUNT];    // largest distance from the landmark to a cell the goal is entered from, minus one
+        };
+
+    public:
+        LandmarkTable();
+
+        // Chooses up to 'count' landmarks (at most MAX_COUNT) on the map and runs BFS from each
+        void compute(const MapIndex& mapIndex, int count = DEFAULT_COUNT);
+
+        int getCount() const { return _landmarks.size(); }
+        // Cell indices of the landmarks
+        const std::vector<int>& getLandmarks() const { return _landmarks; }
+
+        // Bounds towards cell 'goalIndex'; a target of -1 (off the board) gives no bounds
+        Target getTarget(int goalIndex) const;
+
+        // Lower bound on the number of steps from cell 'index' (one that can be walked through,
+        // other than the goal) to the target's goal
+        int getLowerBound(int index, const Target& target) const {
+            const std::uint16_t* distances = &_distances[index * target.count];
+            int result = 0;
+
+            for(int landmark = 0; landmark < target.count; ++landmark) {
+                int distance = distances[landmark];
+                if(distance == UNREACHABLE || target.low[landmark] < 0) {
+                    continue;
+                }
+
+                result = std::max(result, std::max(target.low[landmark] - distance, distance - target.high[landmark]));
+            }
+
+            return result;
+        }
+
+    private:
+        static void _fill(const MapIndex& mapIndex, int source, std::vector<std::uint16_t>& row, std::vector<int>& queue);
+
+        std::vector<int> _landmarks;
+        // cells * landmarks, landmarks of one cell side by side
+        std::vector<std::uint16_t> _distances;
+        // Target::high of every cell: same as _distances for cells that can be walked through
+        std::vector<std::uint16_t> _highs;
+};
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "MapIndex.h"
+
+static const int posDiffs[4][2] = {
+    { -1,  0 }, {  1,  0 }, {  0,  1 }, {  0, -1 }  // NORTH, SOUTH, EAST, WEST
+};
+
+MapIndex::MapIndex(const HashedPair<Tiles>& hashedBackground, const std::vector<Position>& spawns) : _spawns(spawns), _passableCount(0) {
+    const Tiles& background = hashedBackground.value;
+    _width = background.shape()[0];
+    _height = background.shape()[1];
+
+    const int cells = _width * _height;
+    _mineIds.assign(cells, -1);
+    _passable.assign(cells, false);
+    _adjacency.assign(4 * cells, -1);
+
+    if(Bitboard::fits(_width, _height)) {
+        _passableBoard = Bitboard(_width, _height);
+    }
+
+    for(int index = 0; index < cells; ++index) {
+        Position position = getPosition(index);
+
+        switch(get_tile(background, position)) {
+            case EMPTY:
+                _passable[index] = true;
+                ++_passableCount;
+                if(_passableBoard.getWidth() > 0) {
+                    _passableBoard.set(index);
+                }
+                break;
+            case TAVERN:
+                _taverns.push_back(position);
+                break;
+            case MINE:
+                _mineIds[index] = _mines.size();
+                _mines.push_back(position);
+                break;
+            default: break;
+        }
+    }
+
+    for(int index = 0; index < cells; ++index) {
+        Position position = getPosition(index);
+
+        for(int direction = 0; direction < 4; ++direction) {
+            Position neighbour(position.x + posDiffs[direction][0], position.y + posDiffs[direction][1]);
+            int neighbourIndex = getIndex(neighbour);
+            if(neighbourIndex >= 0 && get_tile(background, neighbour) != WOOD) {
+                _adjacency[4 * index + direction] = neighbourIndex;
+            }
+        }
+    }
+
+    _landmarks.compute(*this);
+    _distances = DistanceTable::get(hashedBackground);
+    _corridors.compute(*this);
+    _sectors.compute(*this);
+}
+
+int MapIndex::getIndex(const Position& position) const {
+    if(position.x < 0 || position.y < 0 || position.x >= _width || position.y >= _height) {
+        return -1;
+    }
+
+    return position.x * _height + position.y;
+}
+
+int MapIndex::getMineId(const Position& position) const {
+    int index = getIndex(position);
+
+    return (index < 0) ? -1 : _mineIds[index];
+}
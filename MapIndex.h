@@ -0,0 +1,92 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef MAPINDEX_H_INCLUDED
+#define MAPINDEX_H_INCLUDED
+
+#include "tiles.h"
+#include "hashed.h"
+#include "Bitboard.h"
+#include "DistanceTable.h"
+#include "LandmarkTable.h"
+#include "CorridorGraph.h"
+#include "SectorGraph.h"
+
+#include <vector>
+#include <memory>
+
+/**
+ * Points of interest of a map, collected once per game from the hero-free background:
+ * taverns, mines (with dense ids 0..getMineCount()-1), hero spawn points, the number
+ * of passable cells, the adjacency of every cell, landmark distances for A* bounds, the
+ * all-pairs distance table of small maps, the corridor graph and the sector graph.
+ *
+ * Cells are indexed as `x * height + y`. Nothing here changes during a game, so the
+ * index is shared (read-only) by the game, its states and everything derived from them.
+ */
+class MapIndex {
+    public:
+        typedef std::shared_ptr<const MapIndex> Pointer;
+
+    public:
+        // 'spawns' are hero spawn points in hero order
+        MapIndex(const HashedPair<Tiles>& background, const std::vector<Position>& spawns);
+
+        int getWidth() const { return _width; }
+        int getHeight() const { return _height; }
+
+        // Cell index or -1 for positions outside the board
+        int getIndex(const Position& position) const;
+        Position getPosition(int index) const { return Position(index / _height, index % _height); }
+
+        const std::vector<Position>& getTaverns() const { return _taverns; }
+        const std::vector<Position>& getSpawns() const { return _spawns; }
+
+        // Mine positions ordered by mine id
+        const std::vector<Position>& getMines() const { return _mines; }
+        int getMineCount() const { return _mines.size(); }
+        // Dense id of the mine at 'position', -1 if there is no mine there
+        int getMineId(const Position& position) const;
+
+        // EMPTY cells (heroes walk only through those)
+        bool isPassable(int index) const { return _passable[index]; }
+        int getPassableCount() const { return _passableCount; }
+        // Same cells as a bitboard; empty (0x0) on boards too big for one, see Bitboard::fits()
+        const Bitboard& getPassableBoard() const { return _passableBoard; }
+
+        // Four neighbours of cell 'index' (NORTH, SOUTH, EAST, WEST), -1 for walls and cells
+        // outside the board; the whole table is 4 * cells entries, see getAdjacency()
+        const int* getNeighbours(int index) const { return &_adjacency[4 * index]; }
+        const std::vector<int>& getAdjacency() const { return _adjacency; }
+
+        // Lower bounds on path lengths for A* heuristics
+        const LandmarkTable& getLandmarks() const { return _landmarks; }
+        // Exact hero-free distances (so lower bounds with heroes), null on boards above DistanceTable::MAX_CELLS
+        const DistanceTable* getDistances() const { return _distances.get(); }
+
+        // Junctions and the corridors between them, for long-range point-to-point queries
+        const CorridorGraph& getCorridors() const { return _corridors; }
+        // Sectors and portals between them, for point-to-point queries on large boards
+        const SectorGraph& getSectors() const { return _sectors; }
+
+    private:
+        int _width;
+        int _height;
+        std::vector<Position> _taverns;
+        std::vector<Position> _mines;
+        std::vector<Position> _spawns;
+        std::vector<int> _mineIds;      // cell index -> mine id or -1
+        std::vector<bool> _passable;
+        int _passableCount;
+        Bitboard _passableBoard;
+        std::vector<int> _adjacency;
+        LandmarkTable _landmarks;
+        DistanceTable::Pointer _distances;
+        CorridorGraph _corridors;
+        SectorGraph _sectors;
+};
+
+#endif
@@ -43,22 +43,22 @@ Direction MediumStrategy::getMove() {
         }
     }
 
-    Path::PathType path1 = Path::getPath(_game.state, _game.state.heroes[_heroNumber].position, _goal, avoid);
-    Path::PathType path2 = Path::getPath(_game.state, _game.state.heroes[_heroNumber].position, _tavern, _avoid);
+    Path::Result path1 = Path::query(_game.state, _game.state.heroes[_heroNumber].position, _goal, avoid);
+    Path::Result path2 = Path::query(_game.state, _game.state.heroes[_heroNumber].position, _tavern, _avoid);
 
-    Path::PathType path;
+    Path::Result path;
 
-    if(health-(int)path1.size() < 40) {
+    if(health-path1.distance < 40) {
         path = path2;
     } else {
         path = path1;
     }
 
-    if(path.size() == 0) {
+    if(!path.found()) {
         return STAY;
     }
 
-    return Path::getDirection(_game.state.heroes[_heroNumber].position, path.front());
+    return path.direction;
 }
 
 Tile MediumStrategy::getHeroFromIndex(int index) {
@@ -6,18 +6,210 @@
 
 #include "Path.h"
 #include "Graph/AStar.hpp"
-
-#include <cmath>
+#include "Graph/FlatAStar.hpp"
+#include "Graph/PolicyAStar.hpp"
+#include "Graph/JumpPointSearch.hpp"
+#include "Graph/BidirectionalSearch.hpp"
+#include "Graph/BucketSearch.hpp"
+#include "Graph/PolicyGraphAdapter.hpp"
+#include "DistanceField.h"
+#include "DangerField.h"
+#include "PathCache.h"
+#include "StateOverlay.h"
+
+#include <cstdlib>
+#include <cassert>
 #include <climits>
 #include <algorithm>
+#include <type_traits>
 
 /*** Typedefs ***/
-typedef Graph::GraphAdapter<State, Position, double> BaseGraphAdapter;
+typedef Graph::AStarWorkspace<Position, double> PathWorkspace;
+
+/*** Engine used by getPath methods ***/
+static Path::Engine pathEngine = Path::POLICY_ASTAR;
+
+/*** Boards with more cells answer point-to-point queries hierarchically ***/
+static int hierarchicalThreshold = 64 * 64;
+
+/*** Nodes expanded by the last search of the calling thread (for Path::benchmark) ***/
+static thread_local unsigned int lastExpansions = 0;
+
+/*** Search memory reused by consecutive queries of the calling thread ***/
+static PathWorkspace& getWorkspace(const State& state) {
+    static thread_local PathWorkspace workspace;
+
+    const Tiles& background = state.get_background_tiles();
+    workspace.resize(background.shape()[0], background.shape()[1]);
+
+    return workspace;
+}
+
+/*** Memory of an engine besides the workspace (JumpPointMemory, ...), sized by its first search on the calling thread ***/
+template<typename MemoryType>
+static MemoryType& getEngineMemory() {
+    static thread_local MemoryType memory;
+
+    return memory;
+}
+
+/*** Search of the statically dispatched engines for uniform step costs ***/
+template<typename AdapterType, typename GoalType>
+static int runPolicySearch(PathWorkspace& workspace, const AdapterType& adapter, const Position& start, const GoalType& goal, std::true_type) {
+    int goalIndex;
+
+    // Jump points are only valid with uniform step costs and an admissible heuristic
+    if(pathEngine == Path::JUMP_POINT) {
+        Graph::JumpPointSearch<AdapterType> mySearch(workspace, getEngineMemory<Graph::JumpPointMemory>());
+        goalIndex = mySearch.search(adapter, start, goal);
+        lastExpansions = mySearch.getExpansions();
+    } else {
+        Graph::PolicyAStar<AdapterType> myAStar(workspace);
+        goalIndex = myAStar.search(adapter, start, goal);
+        lastExpansions = myAStar.getExpansions();
+    }
+
+    return goalIndex;
+}
+
+/*** Same for weighted steps, on the integer bucket queue ***/
+template<typename AdapterType, typename GoalType>
+static int runPolicySearch(PathWorkspace& workspace, const AdapterType& adapter, const Position& start, const GoalType& goal, std::false_type) {
+    Graph::BucketSearch<AdapterType> mySearch(workspace, getEngineMemory<Graph::BucketMemory>());
+    int goalIndex = mySearch.search(adapter, start, goal);
+    lastExpansions = mySearch.getExpansions();
+
+    return goalIndex;
+}
+
+/*** Search of the statically dispatched engines, parents of the path stay in the workspace ***/
+template<typename AdapterType, typename GoalType>
+static int runPolicySearch(PathWorkspace& workspace, const AdapterType& adapter, const Position& start, const GoalType& goal) {
+    return runPolicySearch(workspace, adapter, start, goal, std::integral_constant<bool, AdapterType::UNIFORM_COST>());
+}
+
+/*** Engines searching with the statically dispatched runPolicySearch ***/
+static bool isPolicyEngine(Path::Engine engine) {
+    return (engine == Path::POLICY_ASTAR || engine == Path::JUMP_POINT || engine == Path::BIDIRECTIONAL || engine == Path::CORRIDOR);
+}
+
+/*** Runs the query on the engine selected with Path::setEngine ***/
+template<typename AdapterType, typename GoalType>
+static Path::PathType runSearch(const State& state, const AdapterType& adapter, const Position& start, const GoalType& goal) {
+    typedef Graph::PolicyGraphAdapter<AdapterType, State> GraphAdapterType;
+    typedef typename GraphAdapterType::NodeAdapterType NodeAdapterType;
+
+    Path::PathType result;
+
+    if(isPolicyEngine(pathEngine)) {
+        PathWorkspace& workspace = getWorkspace(state);
+        return workspace.getPath<Path::PathType>(runPolicySearch(workspace, adapter, start, goal));
+    }
+
+    // Same map rules through the virtual GraphAdapter interface
+    GraphAdapterType graphAdapter(state, adapter);
+    std::function<bool(const NodeAdapterType&)> endCondition = [&](const NodeAdapterType& currentNode) -> bool {
+        return goal.isGoal(currentNode.position);
+    };
+
+    if(pathEngine == Path::SET_ASTAR) {
+        Graph::AStar<State, Position, double> myAStar;
+        result = myAStar.getPath(graphAdapter, NodeAdapterType(start), endCondition);
+    } else {
+        Graph::FlatAStar<State, Position, double> myAStar(getWorkspace(state));
+        result = myAStar.getPath(graphAdapter, NodeAdapterType(start), endCondition);
+    }
+    lastExpansions = graphAdapter.getExpansions();
+
+    return result;
+}
+
+/*** Path::query answer read from a full path ***/
+static Path::Result getResult(const Position& start, const Path::PathType& path, std::vector<Position>* buffer) {
+    Path::Result result;
+
+    if(buffer) {
+        buffer->assign(path.begin(), path.end());
+    }
+
+    if(!path.empty()) {
+        result.direction = Path::getDirection(start, path.front());
+        result.distance = path.size();
+        result.goal = path.back();
+    }
+
+    return result;
+}
+
+/*** Path::query answer read from the parents a search left in the workspace ***/
+static Path::Result getResult(const Position& start, const PathWorkspace& workspace, int goalIndex, std::vector<Position>* path) {
+    Path::Result result;
+
+    if(path) {
+        workspace.getPath(goalIndex, *path);
+    }
+
+    if(goalIndex >= 0) {
+        int firstStep = workspace.getFirstStep(goalIndex, result.distance);
+        result.direction = Path::getDirection(start, workspace.positionOf(firstStep));
+        result.goal = workspace.positionOf(goalIndex);
+    }
+
+    return result;
+}
+
+/*** Runs the query like runSearch, the policy engines answer it straight from the workspace ***/
+template<typename AdapterType, typename GoalType>
+static Path::Result runQuery(const State& state, const AdapterType& adapter, const Position& start, const GoalType& goal, std::vector<Position>* path) {
+    if(!isPolicyEngine(pathEngine)) {
+        return getResult(start, runSearch(state, adapter, start, goal), path);
+    }
+
+    PathWorkspace& workspace = getWorkspace(state);
+
+    return getResult(start, workspace, runPolicySearch(workspace, adapter, start, goal), path);
+}
+
+/*** Visits the four neighbours of a cell, shared by the map adapters ***/
+template<typename Visitor>
+static inline void forEachGridNeighbour(const Position& position, const Visitor& visitor) {
+    visitor(Position(position.x, position.y - 1));
+    visitor(Position(position.x, position.y + 1));
+    visitor(Position(position.x - 1, position.y));
+    visitor(Position(position.x + 1, position.y));
+}
+
+/*** Tile of a cell as the map adapters see it, on a State or on an overlay of one ***/
+static inline Tile getBoardTile(const State& state, const Position& position) {
+    return state.get_tile_from_background_border_check(position);
+}
+
+static inline Tile getBoardTile(const StateOverlay& overlay, const Position& position) {
+    return overlay.getTile(position);
+}
+
+static inline const State& getBoardState(const State& state) {
+    return state;
+}
+
+static inline const State& getBoardState(const StateOverlay& overlay) {
+    return overlay.getState();
+}
+
+/*** Simple A* map adapter (and its goal) for getPath(state, start, end) method ***/
+template<typename BoardType>
+class BasicSimpleMapAdapter {
+    public:
+        typedef Position PositionType;
+        typedef double CostType;
+
+        static const bool UNIFORM_COST = true;
 
-/*** Simple A* graph adapter for getPath(state, start, end) method ***/
-class SimpleMapAdapter : public BaseGraphAdapter {
     public:
-        SimpleMapAdapter(const State& state, const Position& goal) : BaseGraphAdapter(state), _goal(goal) {
+        BasicSimpleMapAdapter(const BoardType& board, const Position& goal)
+                : _board(board), _goal(goal), _mapIndex(*getBoardState(board).get_map_index()),
+                  _distances(_mapIndex.getDistances()),
+                  _target(_mapIndex.getLandmarks().getTarget(_mapIndex.getIndex(goal))) {
 
         }
 
@@ -26,354 +218,300 @@ class SimpleMapAdapter : public BaseGraphAdapter {
 
             if(position == _goal)
                 isAvailable = true;
-            else if(_graph.get_tile_from_background_border_check(position) == Tile::EMPTY)
+            else if(getBoardTile(_board, position) == Tile::EMPTY)
                 isAvailable = true;
 
             return isAvailable;
         }
 
-        std::vector<NodeAdapterType> getNeighboursOf(const NodeAdapterType& node) const {
-            std::vector<NodeAdapterType> neighbours;
-
-            std::vector<std::pair<int, int>> posDiffs = {
-                {  0, -1 }, {  0,  1 }, { -1,  0 }, {  1,  0 }
-            };
+        template<typename Visitor>
+        void forEachNeighbour(const Position& position, const Visitor& visitor) const {
+            forEachGridNeighbour(position, visitor);
+        }
 
-            for(const std::pair<int, int>& posDiff : posDiffs) {
-                neighbours.push_back(
-                    NodeAdapterType(
-                        Position(
-                            node.position.x + posDiff.first,
-                            node.position.y + posDiff.second
-                        )
-                    )
-                );
+        // Manhattan distance or, when larger (there are walls in the way), the distance without heroes
+        // from the map's DistanceTable or the landmark bound on maps too big for one
+        double getHeuristicCostLeft(const Position& position) const {
+            int index = _mapIndex.getIndex(position);
+            int result = std::abs(position.x - _goal.x) + std::abs(position.y - _goal.y);
+
+            if(index >= 0 && position != _goal) {
+                if(_distances) {
+                    result = std::max(result, _distances->getDistance(position, _goal));
+                } else {
+                    result = std::max(result, _mapIndex.getLandmarks().getLowerBound(index, _target));
+                }
             }
 
-            return neighbours;
+            return result;
         }
 
-        virtual double getHeuristicCostLeft(const NodeAdapterType& currentNode, const NodeAdapterType& goal) const {
-            double dx, dy;
-
-            dx = currentNode.position.x - goal.position.x;
-            dy = currentNode.position.y - goal.position.y;
-
-            return std::sqrt(dx*dx + dy*dy);
+        bool isGoal(const Position& position) const {
+            return position == _goal;
         }
 
     private:
+        const BoardType& _board;
         const Position& _goal;
+        const MapIndex& _mapIndex;
+        const DistanceTable* _distances;    // null on large maps
+        LandmarkTable::Target _target;
+
+};
+
+typedef BasicSimpleMapAdapter<State> SimpleMapAdapter;
+
+/*** True if point-to-point queries on the board of 'state' are answered hierarchically ***/
+static bool isLargeBoard(const State& state) {
+    const MapIndex& mapIndex = *state.get_map_index();
+
+    return isPolicyEngine(pathEngine) && mapIndex.getWidth() * mapIndex.getHeight() > hierarchicalThreshold;
+}
+
+/*** Point-to-point search of the BIDIRECTIONAL engine, parents of the path stay in the workspace ***/
+static int runBidirectionalSearch(PathWorkspace& workspace, const SimpleMapAdapter& adapter, const Position& start, const Position& end) {
+    Graph::BidirectionalSearch<SimpleMapAdapter> mySearch(workspace, getEngineMemory<Graph::BidirectionalMemory>());
+    int goalIndex = mySearch.search(adapter, start, end);
+    lastExpansions = mySearch.getExpansions();
+
+    return goalIndex;
+}
+
+/*** Result of a query answered on cell indices (CORRIDOR engine and large boards) ***/
+static Path::Result getResult(const MapIndex& mapIndex, const Position& start, const Position& end, int distance,
+                              const std::vector<int>& cells, std::vector<Position>* path) {
+    Path::Result result;
+    result.distance = distance;
+    if(result.found()) {
+        result.direction = Path::getDirection(start, mapIndex.getPosition(cells.front()));
+        result.goal = end;
+    }
+
+    if(path) {
+        path->clear();
+        for(int cell : cells) {
+            path->push_back(mapIndex.getPosition(cell));
+        }
+    }
+
+    return result;
+}
+
+/*** Cells of the heroes, which block point-to-point queries ***/
+static const std::vector<int>& getHeroCells(const State& state) {
+    static thread_local std::vector<int> blocked;
+
+    const MapIndex& mapIndex = *state.get_map_index();
+    blocked.clear();
+    for(int i = 0; i < 4; ++i) {
+        blocked.push_back(mapIndex.getIndex(state.heroes[i].position));
+    }
+
+    return blocked;
+}
+
+/*** Point-to-point query of the CORRIDOR engine, same rules as SimpleMapAdapter (heroes block their cells) ***/
+static Path::Result runCorridorQuery(const State& state, const Position& start, const Position& end, std::vector<Position>* path) {
+    static thread_local std::vector<int> cells;
+
+    const MapIndex& mapIndex = *state.get_map_index();
+    int distance = mapIndex.getCorridors().query(mapIndex, getHeroCells(state), mapIndex.getIndex(start), mapIndex.getIndex(end), &cells, &lastExpansions);
+
+    return getResult(mapIndex, start, end, distance, cells, path);
+}
+
+/*** Point-to-point query on large boards: refined route over the SectorGraph, full search when a hero blocks it ***/
+static Path::Result runHierarchicalQuery(const State& state, const SimpleMapAdapter& adapter, const Position& start, const Position& end,
+                                         std::vector<Position>* path) {
+    static thread_local std::vector<int> cells;
+
+    const MapIndex& mapIndex = *state.get_map_index();
+    unsigned int expansions = 0;
+    int distance = mapIndex.getSectors().query(mapIndex, getHeroCells(state), mapIndex.getIndex(start), mapIndex.getIndex(end), &cells, &expansions);
+
+    if(distance < 0) {
+        PathWorkspace& workspace = getWorkspace(state);
+        int goalIndex = runPolicySearch(workspace, adapter, start, adapter);
+        lastExpansions += expansions;
 
+        return getResult(start, workspace, goalIndex, path);
+    }
+
+#if !defined(NDEBUG)
+    // "No path" from the portals has to be the answer of the cells too
+    if(distance == 0) {
+        assert( runPolicySearch(getWorkspace(state), adapter, start, adapter) < 0 );
+    }
+#endif
+
+    lastExpansions = expansions;
+    return getResult(mapIndex, start, end, distance, cells, path);
+}
+
+/*** Point-to-point search on the engine selected with Path::setEngine ***/
+static Path::PathType runPointSearch(const State& state, const SimpleMapAdapter& adapter, const Position& start, const Position& end) {
+    if(isLargeBoard(state)) {
+        std::vector<Position> path;
+        runHierarchicalQuery(state, adapter, start, end, &path);
+        return Path::PathType(path.begin(), path.end());
+    }
+
+    if(pathEngine == Path::BIDIRECTIONAL) {
+        PathWorkspace& workspace = getWorkspace(state);
+        return workspace.getPath<Path::PathType>(runBidirectionalSearch(workspace, adapter, start, end));
+    }
+
+    if(pathEngine == Path::CORRIDOR) {
+        std::vector<Position> path;
+        runCorridorQuery(state, start, end, &path);
+        return Path::PathType(path.begin(), path.end());
+    }
+
+    return runSearch(state, adapter, start, adapter);
+}
+
+/*** Goal of getPath(state, start, tileTypes) methods: any tile of the given types ***/
+template<typename BoardType>
+class BasicTileGoal {
+    public:
+        BasicTileGoal(const BoardType& board, const std::vector<Tile>& goalTypes) : _board(board), _goalMask(Path::getTileMask(goalTypes)) {
+
+        }
+
+        bool isGoal(const Position& position) const {
+            return (_goalMask & (1 << getBoardTile(_board, position))) != 0;
+        }
+
+    private:
+        const BoardType& _board;
+        int _goalMask;
 };
 
-/*** Advanced A* graph adapter for getPath(state, start, tileTypes) method ***/
-class AdvancedMapAdapter : public BaseGraphAdapter {
+typedef BasicTileGoal<State> TileGoal;
+
+/*** Avoided cells of tile goal queries: the shared per-state field, or one refilled in place for an overlay ***/
+static const DangerField* getDangerField(const State& state, const std::vector<Tile>& avoidTypes) {
+    return avoidTypes.empty() ? NULL : &DangerField::get(state, avoidTypes);
+}
+
+static const DangerField* getDangerField(const StateOverlay& overlay, const std::vector<Tile>& avoidTypes) {
+    static thread_local DangerField field;
+    static thread_local std::vector<Position> avoidPositions;
+
+    if(avoidTypes.empty()) {
+        return NULL;
+    }
+
+    avoidPositions.clear();
+    Path::getTilePositions(overlay, avoidTypes, avoidPositions);
+    field.compute(*overlay.getState().get_map_index(), avoidPositions);
+
+    return &field;
+}
+
+/*** Advanced A* map adapter for getPath(state, start, tileTypes) method ***/
+template<typename BoardType>
+class BasicAdvancedMapAdapter {
     public:
-        AdvancedMapAdapter(const State& state, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes)
-                : BaseGraphAdapter(state), _tileTypes(goalTypes), _avoidTypes(avoidTypes) {
+        typedef Position PositionType;
+        typedef double CostType;
 
+        static const bool UNIFORM_COST = false;     // entering an avoided cell costs extra, see getStepCost
+
+    public:
+        // Goal positions are written to 'goalBuffer' when given (a caller's buffer kept between its queries),
+        // to the adapter's own vector otherwise
+        BasicAdvancedMapAdapter(const BoardType& board, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes,
+                                std::vector<PositionType>* goalBuffer = NULL)
+                : _board(board), _availableMask(Path::getTileMask(goalTypes) | (1 << EMPTY)),
+                  _danger(getDangerField(board, avoidTypes)),
+                  _dangerCost(getBoardState(board).get_background_tiles().num_elements()),
+                  _goalPositions(goalBuffer ? *goalBuffer : _ownGoalPositions) {
+            // Resolved once per query, so the heuristic only walks a plain position list
+            _goalPositions.clear();
+            Path::getTilePositions(board, goalTypes, _goalPositions);
         }
 
-        bool isAvailable(const Position& position) const {
-            bool isAvailable = false;
-            Tile tileOnPosition;
+        BasicAdvancedMapAdapter(const BasicAdvancedMapAdapter&) = delete;
+        BasicAdvancedMapAdapter& operator=(const BasicAdvancedMapAdapter&) = delete;
 
-            tileOnPosition = _graph.get_tile_from_background_border_check(position);
-            if(tileOnPosition == Tile::EMPTY)
-                isAvailable = true;
+        bool isAvailable(const Position& position) const {
+            return (_availableMask & (1 << getBoardTile(_board, position))) != 0;
+        }
 
-            for(unsigned int i = 0; i < _tileTypes.size(); ++i) {
-                if(tileOnPosition == _tileTypes[i]) {
-                    isAvailable = true;
-                    break;
-                }
-            }
+        template<typename Visitor>
+        void forEachNeighbour(const Position& position, const Visitor& visitor) const {
+            forEachGridNeighbour(position, visitor);
+        }
 
-            return isAvailable;
+        // Dangerous cells cost more than any path without them (one step per board cell), so the cheapest
+        // path enters as few of them as possible and is the shortest of those - the order of PathSurvey
+        int getStepCost(const Position&, const Position& to) const {
+            return (_danger && _danger->isDangerous(to)) ? 1 + _dangerCost : 1;
         }
 
-        std::vector<NodeAdapterType> getNeighboursOf(const NodeAdapterType& node) const {
-            std::vector<NodeAdapterType> neighbours;
+        int getMaxStepCost() const {
+            return _danger ? 1 + _dangerCost : 1;
+        }
 
-            std::vector<std::pair<int, int>> posDiffs = {
-                {  0, -1 }, {  0,  1 }, { -1,  0 }, {  1,  0 }
-            };
+        // Manhattan distance to the nearest goal, 0 without goals
+        int getLowerBound(const Position& currentPosition) const {
+            int result = INT_MAX;
 
-            for(const std::pair<int, int>& posDiff : posDiffs) {
-                neighbours.push_back(
-                    NodeAdapterType(
-                        Position(
-                            node.position.x + posDiff.first,
-                            node.position.y + posDiff.second
-                        )
-                    )
-                );
+            for(const PositionType& pos : _goalPositions) {
+                result = std::min(result, std::abs(currentPosition.x - pos.x) + std::abs(currentPosition.y - pos.y));
             }
 
-            return neighbours;
+            return ( (result == INT_MAX) ? 0 : result );
         }
 
-        double getHeuristicCostLeft(const NodeAdapterType& currentNode, const NodeAdapterType& currentNodeCpy) const {
-            static std::vector<PositionType> tavernPositions = _getTavernPositions();
-            static std::vector<PositionType> minesPositions = _getMinesPositions();
-
+        // Engines with unit steps only (SET_ASTAR, FLAT_ASTAR) avoid cells by inflating this heuristic
+        double getHeuristicCostLeft(const Position& currentPosition) const {
             double result = INT_MAX;
-            PositionType position;
-            PositionType currentPosition = currentNode.position;
             double distance, diffx, diffy;
 
-            for(Tile t: _tileTypes) {
-                switch(t) {
-                    case HERO1:
-                        position = _graph.heroes[0].position;
-                        diffx = currentPosition.x - position.x;
-                        diffy = currentPosition.y - position.y;
-                        distance = diffx * diffx + diffy * diffy;
-                        result = std::min(result, distance);
-                        break;
-                    case HERO2:
-                        position = _graph.heroes[1].position;
-                        diffx = currentPosition.x - position.x;
-                        diffy = currentPosition.y - position.y;
-                        distance = diffx * diffx + diffy * diffy;
-                        result = std::min(result, distance);
-                        break;
-                    case HERO3:
-                        position = _graph.heroes[2].position;
-                        diffx = currentPosition.x - position.x;
-                        diffy = currentPosition.y - position.y;
-                        distance = diffx * diffx + diffy * diffy;
-                        result = std::min(result, distance);
-                        break;
-                    case HERO4:
-                        position = _graph.heroes[3].position;
-                        diffx = currentPosition.x - position.x;
-                        diffy = currentPosition.y - position.y;
-                        distance = diffx * diffx + diffy * diffy;
-                        result = std::min(result, distance);
-                        break;
-                    case TAVERN:
-                        for(PositionType pos: tavernPositions) {
-                            diffx = currentPosition.x - pos.x;
-                            diffy = currentPosition.y - pos.y;
-                            distance = diffx * diffx + diffy * diffy;
-                            result = std::min(result, distance);
-                        }
-                        break;
-                    case MINE:
-                        for(PositionType pos: minesPositions) {
-                            bool owned = false;
-                            for(int i = 0; i < 4; ++i) {
-                                owned = (owned || (_graph.heroes[i].mine_positions.find(pos) != _graph.heroes[i].mine_positions.end()));
-                            }
-                            if(!owned) {
-                                diffx = currentPosition.x - pos.x;
-                                diffy = currentPosition.y - pos.y;
-                                distance = diffx * diffx + diffy * diffy;
-                                result = std::min(result, distance);
-                            }
-                        }
-                        break;
-                    case MINE1:
-                        for(PositionType pos: _graph.heroes[0].mine_positions) {
-                            diffx = currentPosition.x - pos.x;
-                            diffy = currentPosition.y - pos.y;
-                            distance = diffx * diffx + diffy * diffy;
-                            result = std::min(result, distance);
-                        }
-                        break;
-                    case MINE2:
-                        for(PositionType pos: _graph.heroes[1].mine_positions) {
-                            diffx = currentPosition.x - pos.x;
-                            diffy = currentPosition.y - pos.y;
-                            distance = diffx * diffx + diffy * diffy;
-                            result = std::min(result, distance);
-                        }
-                        break;
-                    case MINE3:
-                        for(PositionType pos: _graph.heroes[2].mine_positions) {
-                            diffx = currentPosition.x - pos.x;
-                            diffy = currentPosition.y - pos.y;
-                            distance = diffx * diffx + diffy * diffy;
-                            result = std::min(result, distance);
-                        }
-                        break;
-                    case MINE4:
-                        for(PositionType pos: _graph.heroes[3].mine_positions) {
-                            diffx = currentPosition.x - pos.x;
-                            diffy = currentPosition.y - pos.y;
-                            distance = diffx * diffx + diffy * diffy;
-                            result = std::min(result, distance);
-                        }
-                        break;
-                    default: break;
-                }
+            for(const PositionType& pos : _goalPositions) {
+                diffx = currentPosition.x - pos.x;
+                diffy = currentPosition.y - pos.y;
+                distance = diffx * diffx + diffy * diffy;
+                result = std::min(result, distance);
             }
 
-            result = getCostWithAvoidance(currentNode, result);
+            result = getCostWithAvoidance(currentPosition, result);
 
             return ( (result == INT_MAX) ? 0 : result );
         }
 
-        double getCostWithAvoidance(const NodeAdapterType& currentNode, double oldResult) const {
-            static std::vector<PositionType> tavernPositions = _getTavernPositions();
-            static std::vector<PositionType> minesPositions = _getMinesPositions();
-
-            double newResult = oldResult;
-            PositionType position;
-            PositionType currentPosition = currentNode.position;
-            int diffx, diffy;
-
-            int maxDXDY = 2;
-
-            for(Tile t: _avoidTypes) {
-                switch(t) {
-                    case HERO1:
-                        position = _graph.heroes[0].position;
-                        diffx = std::abs(currentPosition.x - position.x);
-                        diffy = std::abs(currentPosition.y - position.y);
-                        if(diffx + diffy <= maxDXDY) {
-                            newResult = oldResult + 99999.0;
-                        }
-                        break;
-                    case HERO2:
-                        position = _graph.heroes[1].position;
-                        diffx = std::abs(currentPosition.x - position.x);
-                        diffy = std::abs(currentPosition.y - position.y);
-                        if(diffx + diffy <= maxDXDY) {
-                            newResult = oldResult + 99999.0;
-                        }
-                        break;
-                    case HERO3:
-                        position = _graph.heroes[2].position;
-                        diffx = std::abs(currentPosition.x - position.x);
-                        diffy = std::abs(currentPosition.y - position.y);
-                        if(diffx + diffy <= maxDXDY) {
-                            newResult = oldResult + 99999.0;
-                        }
-                        break;
-                    case HERO4:
-                        position = _graph.heroes[3].position;
-                        diffx = std::abs(currentPosition.x - position.x);
-                        diffy = std::abs(currentPosition.y - position.y);
-                        if(diffx + diffy <= maxDXDY) {
-                            newResult = oldResult + 99999.0;
-                        }
-                        break;
-                    case TAVERN:
-                        for(PositionType pos: tavernPositions) {
-                            diffx = std::abs(currentPosition.x - pos.x);
-                            diffy = std::abs(currentPosition.y - pos.y);
-                            if(diffx + diffy <= maxDXDY) {
-                                newResult = oldResult + 99999.0;
-                            }
-                        }
-                        break;
-                    case MINE:
-                        for(PositionType pos: minesPositions) {
-                            bool owned = false;
-                            for(int i = 0; i < 4; ++i) {
-                                owned = (owned || (_graph.heroes[i].mine_positions.find(pos) != _graph.heroes[i].mine_positions.end()));
-                            }
-                            if(!owned) {
-                                diffx = std::abs(currentPosition.x - pos.x);
-                                diffy = std::abs(currentPosition.y - pos.y);
-                                if(diffx + diffy <= maxDXDY) {
-                                    newResult = oldResult + 99999.0;
-                                }
-                            }
-                        }
-                        break;
-                    case MINE1:
-                        for(PositionType pos: _graph.heroes[0].mine_positions) {
-                            diffx = std::abs(currentPosition.x - pos.x);
-                            diffy = std::abs(currentPosition.y - pos.y);
-                            if(diffx + diffy <= maxDXDY) {
-                                newResult = oldResult + 99999.0;
-                            }
-                        }
-                        break;
-                    case MINE2:
-                        for(PositionType pos: _graph.heroes[1].mine_positions) {
-                            diffx = std::abs(currentPosition.x - pos.x);
-                            diffy = std::abs(currentPosition.y - pos.y);
-                            if(diffx + diffy <= maxDXDY) {
-                                newResult = oldResult + 99999.0;
-                            }
-                        }
-                        break;
-                    case MINE3:
-                        for(PositionType pos: _graph.heroes[2].mine_positions) {
-                            diffx = std::abs(currentPosition.x - pos.x);
-                            diffy = std::abs(currentPosition.y - pos.y);
-                            if(diffx + diffy <= maxDXDY) {
-                                newResult = oldResult + 99999.0;
-                            }
-                        }
-                        break;
-                    case MINE4:
-                        for(PositionType pos: _graph.heroes[3].mine_positions) {
-                            diffx = std::abs(currentPosition.x - pos.x);
-                            diffy = std::abs(currentPosition.y - pos.y);
-                            if(diffx + diffy <= maxDXDY) {
-                                newResult = oldResult + 99999.0;
-                            }
-                        }
-                        break;
-                    default: break;
-                }
-            }
-
-            return newResult;
+        double getCostWithAvoidance(const Position& currentPosition, double oldResult) const {
+            return (_danger ? oldResult + _danger->getPenalty(currentPosition) : oldResult);
         }
 
 
     private:
-        std::vector<PositionType> _getTavernPositions() const {
-            int mapSize = _graph.get_tiles_full().shape()[0];
-            std::vector<PositionType> positions;
-            for(int i = 0; i < mapSize; ++i) {
-                for(int j = 0; j < mapSize; ++j) {
-                    PositionType position(i, j);
-                    if(_graph.get_tile_from_background(position) == TAVERN) {
-                        positions.push_back(position);
-                    }
-                }
-            }
-            return positions;
-        }
-
-        std::vector<PositionType> _getMinesPositions() const {
-            int mapSize = _graph.get_tiles_full().shape()[0];
-            std::vector<PositionType> positions;
-            for(int i = 0; i < mapSize; ++i) {
-                for(int j = 0; j < mapSize; ++j) {
-                    PositionType position(i, j);
-                    Tile t = _graph.get_tile_from_background(position);
-                    if(t == MINE || t == MINE1 || t == MINE2 || t == MINE3 || t == MINE4) {
-                        positions.push_back(position);
-                    }
-                }
-            }
-            return positions;
-        }
-
-        const std::vector<Tile>& _tileTypes;
-        const std::vector<Tile>& _avoidTypes;
+        const BoardType& _board;
+        int _availableMask;
+        const DangerField* _danger;     // null without avoided tiles
+        int _dangerCost;
+        std::vector<PositionType> _ownGoalPositions;
+        std::vector<PositionType>& _goalPositions;
 };
 
+typedef BasicAdvancedMapAdapter<State> AdvancedMapAdapter;
+
 
 Path::PathType Path::getPath(const State& state, const Position& start, const Position& end) {
+    PathCache& cache = PathCache::get(state);
+    PathCache::Key key(pathEngine, start, end);
+    if(const PathType* cached = cache.find(key)) {
+        return *cached;
+    }
+
     PathType result;
-    Graph::AStar<State, Position, double> myAStar;
     SimpleMapAdapter myMapAdapter(state, end);
-    SimpleMapAdapter::NodeAdapterType nodeStart(start);
-    SimpleMapAdapter::NodeAdapterType nodeGoal(end);
 
-    result = myAStar.getPath(myMapAdapter, nodeStart, nodeGoal);
+    result = runPointSearch(state, myMapAdapter, start, end);
 
-    return result;
+    return cache.insert(key, result);
 }
 
 
@@ -390,57 +528,471 @@ Path::PathType Path::getPath(const State& state, const Position& start, Tile til
 
 Path::PathType Path::getPath(const State& state, const Position& start, const std::vector<Tile>& tileTypes) {
     std::vector<Tile> avoidTypes; // empty
+
+    return getPath(state, start, tileTypes, avoidTypes);
+}
+
+Path::PathType Path::getPath(const State& state, const Position& start, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes) {
+    PathCache& cache = PathCache::get(state);
+    PathCache::Key key(pathEngine, start, goalTypes, avoidTypes);
+    if(const PathType* cached = cache.find(key)) {
+        return *cached;
+    }
+
+    if(pathEngine != SET_ASTAR && avoidTypes.empty() && DistanceFields::supports(goalTypes)) {
+        return cache.insert(key, DistanceFields::get(state).getPath(start, goalTypes));
+    }
+
     PathType result;
-    Graph::AStar<State, Position, double> myAStar;
-    AdvancedMapAdapter myMapAdapter(state, tileTypes, avoidTypes);
-    AdvancedMapAdapter::NodeAdapterType nodeStart(start);
-
-    std::function<bool(const AdvancedMapAdapter::NodeAdapterType&)> endCondition = [&](const AdvancedMapAdapter::NodeAdapterType& currentNode) -> bool {
-        bool isGoal = false;
-        Tile tileType;
-
-        tileType = state.get_tile_from_background_border_check(currentNode.position);
-        for(unsigned int i = 0; i < tileTypes.size(); ++i) {
-            if(tileTypes[i] == tileType) {
-                isGoal = true;
-                break;
+    AdvancedMapAdapter myMapAdapter(state, goalTypes, avoidTypes);
+    TileGoal goal(state, goalTypes);
+
+    result = runSearch(state, myMapAdapter, start, goal);
+
+    return cache.insert(key, result);
+}
+
+
+Path::Result Path::query(const State& state, const Position& start, const Position& end, std::vector<Position>* path) {
+    PathCache& cache = PathCache::get(state);
+    PathCache::Key key(pathEngine, start, end);
+    if(!path) {
+        if(const Result* cached = cache.findResult(key)) {
+            return *cached;
+        }
+    }
+
+    SimpleMapAdapter myMapAdapter(state, end);
+
+    if(isLargeBoard(state)) {
+        return cache.insertResult(key, runHierarchicalQuery(state, myMapAdapter, start, end, path));
+    }
+
+    if(pathEngine == CORRIDOR) {
+        return cache.insertResult(key, runCorridorQuery(state, start, end, path));
+    }
+
+    if(pathEngine == BIDIRECTIONAL) {
+        PathWorkspace& workspace = getWorkspace(state);
+        return cache.insertResult(key, getResult(start, workspace, runBidirectionalSearch(workspace, myMapAdapter, start, end), path));
+    }
+
+    return cache.insertResult(key, runQuery(state, myMapAdapter, start, myMapAdapter, path));
+}
+
+Path::Result Path::query(const State& state, const Position& start, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes, std::vector<Position>* path) {
+    PathCache& cache = PathCache::get(state);
+    PathCache::Key key(pathEngine, start, goalTypes, avoidTypes);
+    if(!path) {
+        if(const Result* cached = cache.findResult(key)) {
+            return *cached;
+        }
+    }
+
+    Result result;
+    if(pathEngine != SET_ASTAR && avoidTypes.empty() && DistanceFields::supports(goalTypes)) {
+        const DistanceFields& fields = DistanceFields::get(state);
+        result.distance = std::max(fields.getDistance(start, goalTypes), 0);
+        result.direction = fields.getDirection(start, goalTypes);
+        result.goal = fields.getGoal(start, goalTypes, path);
+    } else {
+        AdvancedMapAdapter myMapAdapter(state, goalTypes, avoidTypes);
+        TileGoal goal(state, goalTypes);
+        result = runQuery(state, myMapAdapter, start, goal, path);
+    }
+
+    return cache.insertResult(key, result);
+}
+
+Path::Result Path::query(const StateOverlay& overlay, const Position& start, const Position& end, std::vector<Position>* path) {
+    BasicSimpleMapAdapter<StateOverlay> myMapAdapter(overlay, end);
+    PathWorkspace& workspace = getWorkspace(overlay.getState());
+
+    return getResult(start, workspace, runPolicySearch(workspace, myMapAdapter, start, myMapAdapter), path);
+}
+
+Path::Result Path::query(const StateOverlay& overlay, const Position& start, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes,
+                         std::vector<Position>* path) {
+    // Overlay queries of one thread run one after another, so their goals keep the buffer's capacity
+    static thread_local std::vector<Position> goalPositions;
+
+    BasicAdvancedMapAdapter<StateOverlay> myMapAdapter(overlay, goalTypes, avoidTypes, &goalPositions);
+    BasicTileGoal<StateOverlay> goal(overlay, goalTypes);
+    PathWorkspace& workspace = getWorkspace(overlay.getState());
+
+    return getResult(start, workspace, runPolicySearch(workspace, myMapAdapter, start, goal), path);
+}
+
+
+/*** Path::Limits as the limits policy of PolicyAStar and BucketSearch ***/
+class QueryLimits {
+    public:
+        QueryLimits(const Path::Limits& limits) : _limits(limits) {
+
+        }
+
+        bool isBeyond(double costF) const {
+            return costF > _limits.maxDistance;
+        }
+
+        // Reading the clock costs more than an expansion, so the deadline is checked every 64 of them
+        bool isCancelled(unsigned int expansions) const {
+            if(_limits.flag && !_limits.flag->test()) {
+                return true;
             }
+
+            return _limits.deadline > 0.0 && expansions % 64 == 0 && get_double_time() > _limits.deadline;
         }
 
-        return isGoal;
-    };
+    private:
+        const Path::Limits& _limits;
+};
+
+/*** Last cancelled query of the calling thread, for Path::resume ***/
+struct PendingQuery {
+    PendingQuery() : active(false), toPoint(false), stateHash(0), generation(0) {
 
-    result = myAStar.getPath(myMapAdapter, nodeStart, endCondition);
+    }
+
+    bool active;
+    bool toPoint;               // point-to-point query, tile goals otherwise
+    Position start;
+    Position end;
+    std::vector<Tile> goalTypes;
+    std::vector<Tile> avoidTypes;
+    Hash stateHash;
+    unsigned int generation;    // of the workspace holding the open list
+};
+
+static thread_local PendingQuery pendingQuery;
+
+/*** Limited search of the statically dispatched engines, unit steps ***/
+template<typename AdapterType, typename GoalType>
+static int runLimitedSearch(PathWorkspace& workspace, const AdapterType& adapter, const Position& start, const GoalType& goal,
+                            const QueryLimits& limits, bool resume, std::true_type) {
+    Graph::PolicyAStar<AdapterType> myAStar(workspace);
+    int goalIndex = resume ? myAStar.resume(adapter, goal, limits) : myAStar.search(adapter, start, goal, limits);
+    lastExpansions = myAStar.getExpansions();
+
+    return goalIndex;
+}
+
+/*** Same for weighted steps ***/
+template<typename AdapterType, typename GoalType>
+static int runLimitedSearch(PathWorkspace& workspace, const AdapterType& adapter, const Position& start, const GoalType& goal,
+                            const QueryLimits& limits, bool resume, std::false_type) {
+    Graph::BucketSearch<AdapterType> mySearch(workspace, getEngineMemory<Graph::BucketMemory>());
+    int goalIndex = resume ? mySearch.resume(adapter, goal, limits) : mySearch.search(adapter, start, goal, limits);
+    lastExpansions = mySearch.getExpansions();
+
+    return goalIndex;
+}
+
+/*** Result cut to the bound of 'limits' ***/
+static Path::Result getBoundedResult(const Path::Result& result, const Path::Limits& limits, std::vector<Position>* path) {
+    if(result.found() && result.distance > limits.maxDistance) {
+        if(path) {
+            path->clear();
+        }
+        return Path::Result();
+    }
 
     return result;
 }
 
-Path::PathType Path::getPath(const State& state, const Position& start, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes) {
-    PathType result;
-    Graph::AStar<State, Position, double> myAStar;
-    AdvancedMapAdapter myMapAdapter(state, goalTypes, avoidTypes);
-    AdvancedMapAdapter::NodeAdapterType nodeStart(start);
+/*** Runs (or resumes) a query within limits; a cancelled one is left for Path::resume ***/
+template<typename AdapterType, typename GoalType>
+static Path::Result runLimitedQuery(const State& state, const AdapterType& adapter, const Position& start, const GoalType& goal,
+                                    const Path::Limits& limits, bool resume, std::vector<Position>* path) {
+    PathWorkspace& workspace = getWorkspace(state);
+    int goalIndex = runLimitedSearch(workspace, adapter, start, goal, QueryLimits(limits), resume,
+                                     std::integral_constant<bool, AdapterType::UNIFORM_COST>());
+
+    if(goalIndex == Graph::SEARCH_CANCELLED) {
+        pendingQuery.active = true;
+        pendingQuery.stateHash = hash_value(state);
+        pendingQuery.generation = workspace.generation();
+
+        Path::Result result;
+        result.cancelled = true;
+        if(path) {
+            path->clear();
+        }
+        return result;
+    }
 
-    std::function<bool(const AdvancedMapAdapter::NodeAdapterType&)> endCondition = [&](const AdvancedMapAdapter::NodeAdapterType& currentNode) -> bool {
-        bool isGoal = false;
-        Tile tileType;
+    // A start that is a goal costs nothing, but still counts as one cell
+    return getBoundedResult(getResult(start, workspace, goalIndex, path), limits, path);
+}
 
-        tileType = state.get_tile_from_background_border_check(currentNode.position);
-        for(unsigned int i = 0; i < goalTypes.size(); ++i) {
-            if(goalTypes[i] == tileType) {
-                isGoal = true;
-                break;
+Path::Result Path::query(const State& state, const Position& start, const Position& end, const Limits& limits, std::vector<Position>* path) {
+    PathCache& cache = PathCache::get(state);
+    PathCache::Key key(pathEngine, start, end);
+    if(!path) {
+        if(const Result* cached = cache.findResult(key)) {
+            return getBoundedResult(*cached, limits, path);
+        }
+    }
+
+    SimpleMapAdapter myMapAdapter(state, end);
+    Result result = runLimitedQuery(state, myMapAdapter, start, myMapAdapter, limits, false, path);
+
+    if(result.cancelled) {
+        pendingQuery.toPoint = true;
+        pendingQuery.start = start;
+        pendingQuery.end = end;
+    } else if(result.found()) {
+        // Found within the bound is the same answer as without it; nothing found may be the bound
+        cache.insertResult(key, result);
+    }
+
+    return result;
+}
+
+Path::Result Path::query(const State& state, const Position& start, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes,
+                         const Limits& limits, std::vector<Position>* path) {
+    // Without avoid types cost and distance are the same, so unlimited answers only need the bound checked
+    if(avoidTypes.empty()) {
+        PathCache& cache = PathCache::get(state);
+        PathCache::Key key(pathEngine, start, goalTypes, avoidTypes);
+        if(!path) {
+            if(const Result* cached = cache.findResult(key)) {
+                return getBoundedResult(*cached, limits, path);
             }
         }
 
-        return isGoal;
-    };
+        if(DistanceFields::supports(goalTypes)) {
+            const DistanceFields& fields = DistanceFields::get(state);
+            Result result;
 
-    result = myAStar.getPath(myMapAdapter, nodeStart, endCondition);
+            result.distance = std::max(fields.getDistance(start, goalTypes), 0);
+            if(result.distance > limits.maxDistance) {
+                return getBoundedResult(result, limits, path);
+            }
+
+            result.direction = fields.getDirection(start, goalTypes);
+            result.goal = fields.getGoal(start, goalTypes, path);
+            return result;
+        }
+    }
+
+    AdvancedMapAdapter myMapAdapter(state, goalTypes, avoidTypes);
+    TileGoal goal(state, goalTypes);
+    Result result = runLimitedQuery(state, myMapAdapter, start, goal, limits, false, path);
+
+    if(result.cancelled) {
+        pendingQuery.toPoint = false;
+        pendingQuery.start = start;
+        pendingQuery.goalTypes = goalTypes;
+        pendingQuery.avoidTypes = avoidTypes;
+    }
 
     return result;
 }
 
+Path::Result Path::resume(const State& state, const Limits& limits, std::vector<Position>* path) {
+    if(!pendingQuery.active || pendingQuery.stateHash != hash_value(state)) {
+        if(path) {
+            path->clear();
+        }
+        return Result();
+    }
+
+    // Copied, as a query cancelled again records itself over it
+    const PendingQuery pending = pendingQuery;
+    pendingQuery.active = false;
+
+    if(getWorkspace(state).generation() != pending.generation) {
+        return pending.toPoint ? query(state, pending.start, pending.end, limits, path)
+                               : query(state, pending.start, pending.goalTypes, pending.avoidTypes, limits, path);
+    }
+
+    if(pending.toPoint) {
+        SimpleMapAdapter myMapAdapter(state, pending.end);
+        return runLimitedQuery(state, myMapAdapter, pending.start, myMapAdapter, limits, true, path);
+    }
+
+    AdvancedMapAdapter myMapAdapter(state, pending.goalTypes, pending.avoidTypes);
+    TileGoal goal(state, pending.goalTypes);
+    return runLimitedQuery(state, myMapAdapter, pending.start, goal, limits, true, path);
+}
+
+
+int Path::getDistance(const State& state, const Position& start, const std::vector<Tile>& goalTypes) {
+    Result result = query(state, start, goalTypes);
+
+    return result.found() ? result.distance : -1;
+}
+
+
+void Path::getTilePositions(const State& state, const std::vector<Tile>& tileTypes, std::vector<Position>& positions) {
+    const MapIndex& mapIndex = *state.get_map_index();
+
+    for(Tile t: tileTypes) {
+        switch(t) {
+            case HERO1:
+            case HERO2:
+            case HERO3:
+            case HERO4:
+                positions.push_back(state.heroes[t - HERO1].position);
+                break;
+            case TAVERN:
+                positions.insert(positions.end(), mapIndex.getTaverns().begin(), mapIndex.getTaverns().end());
+                break;
+            case MINE:
+                for(const Position& pos: mapIndex.getMines()) {
+                    bool owned = false;
+                    for(int i = 0; i < 4; ++i) {
+                        owned = (owned || (state.heroes[i].mine_positions.find(pos) != state.heroes[i].mine_positions.end()));
+                    }
+                    if(!owned) {
+                        positions.push_back(pos);
+                    }
+                }
+                break;
+            case MINE1:
+            case MINE2:
+            case MINE3:
+            case MINE4:
+                positions.insert(positions.end(), state.heroes[t - MINE1].mine_positions.begin(), state.heroes[t - MINE1].mine_positions.end());
+                break;
+            default: break;
+        }
+    }
+}
+
+void Path::getTilePositions(const StateOverlay& overlay, const std::vector<Tile>& tileTypes, std::vector<Position>& positions) {
+    const MapIndex& mapIndex = *overlay.getState().get_map_index();
+
+    for(Tile t: tileTypes) {
+        switch(t) {
+            case HERO1:
+            case HERO2:
+            case HERO3:
+            case HERO4:
+                positions.push_back(overlay.getHeroPosition(t - HERO1));
+                break;
+            case TAVERN:
+                positions.insert(positions.end(), mapIndex.getTaverns().begin(), mapIndex.getTaverns().end());
+                break;
+            case MINE:
+            case MINE1:
+            case MINE2:
+            case MINE3:
+            case MINE4:
+                for(const Position& pos: mapIndex.getMines()) {
+                    if(overlay.getMineOwner(pos) == ((t == MINE) ? -1 : t - MINE1)) {
+                        positions.push_back(pos);
+                    }
+                }
+                break;
+            default: break;
+        }
+    }
+}
+
+
+int Path::getTileMask(const std::vector<Tile>& tileTypes) {
+    int mask = 0;
+
+    for(Tile t : tileTypes) {
+        mask |= (1 << t);
+    }
+
+    return mask;
+}
+
+
+void Path::setEngine(Engine engine) {
+    pathEngine = engine;
+}
+
+Path::Engine Path::getEngine() {
+    return pathEngine;
+}
+
+void Path::setHierarchicalThreshold(int cells) {
+    hierarchicalThreshold = cells;
+}
+
+int Path::getHierarchicalThreshold() {
+    return hierarchicalThreshold;
+}
+
+
+void Path::benchmark(const State& state, std::ostream& os) {
+    const int repeats = 20;
+    // The last row is POLICY_ASTAR answering point-to-point queries hierarchically whatever the board size
+    const Engine engines[] = { SET_ASTAR, FLAT_ASTAR, POLICY_ASTAR, JUMP_POINT, BIDIRECTIONAL, CORRIDOR, POLICY_ASTAR };
+    const int thresholds[] = { INT_MAX, INT_MAX, INT_MAX, INT_MAX, INT_MAX, INT_MAX, 0 };
+    const char* engineNames[] = { "set", "flat", "policy", "jump", "bidirectional", "corridor", "hierarchical" };
+
+    std::vector<Tile> goalTypes;
+    goalTypes.push_back(TAVERN);
+    goalTypes.push_back(MINE);
+
+    // Point-to-point queries as strategies ask them: hero to hero and hero to tavern
+    std::vector<std::pair<Position, Position>> points;
+    for(int i = 0; i < 4; ++i) {
+        for(int j = 0; j < 4; ++j) {
+            if(i != j) {
+                points.push_back(std::make_pair(state.heroes[i].position, state.heroes[j].position));
+            }
+        }
+        for(const Position& tavern : state.get_map_index()->getTaverns()) {
+            points.push_back(std::make_pair(state.heroes[i].position, tavern));
+        }
+    }
+
+    Engine previousEngine = pathEngine;
+    int previousThreshold = hierarchicalThreshold;
+
+    for(int e = 0; e < 7; ++e) {
+        pathEngine = engines[e];
+        hierarchicalThreshold = thresholds[e];
+
+        unsigned long long tileQueries = 0, tileExpansions = 0, pointQueries = 0, pointExpansions = 0, checksum = 0;
+        double startTime = get_double_time();
+
+        for(int r = 0; r < repeats; ++r) {
+            for(int i = 0; i < 4; ++i) {
+                const Position& start = state.heroes[i].position;
+                std::vector<Tile> avoidTypes;
+                avoidTypes.push_back((Tile)(HERO1 + (i + 1) % 4));
+
+                // Called through runSearch directly, so DistanceFields and the cache do not answer the query
+                AdvancedMapAdapter advancedAdapter(state, goalTypes, avoidTypes);
+                TileGoal goal(state, goalTypes);
+                checksum += runSearch(state, advancedAdapter, start, goal).size();
+                tileExpansions += lastExpansions;
+                ++tileQueries;
+            }
+        }
+
+        double middleTime = get_double_time();
+
+        for(int r = 0; r < repeats; ++r) {
+            for(const std::pair<Position, Position>& point : points) {
+                SimpleMapAdapter simpleAdapter(state, point.second);
+                checksum += runPointSearch(state, simpleAdapter, point.first, point.second).size();
+                pointExpansions += lastExpansions;
+                ++pointQueries;
+            }
+        }
+
+        double endTime = get_double_time();
+
+        os << "path " << engineNames[e] << ": "
+           << "tiles " << ((middleTime - startTime) * 1e6 / tileQueries) << "us/query "
+           << (double(tileExpansions) / tileQueries) << " expansions/query, "
+           << "points " << ((endTime - middleTime) * 1e6 / pointQueries) << "us/query "
+           << (double(pointExpansions) / pointQueries) << " expansions/query, "
+           << "checksum " << checksum << std::endl;
+    }
+
+    pathEngine = previousEngine;
+    hierarchicalThreshold = previousThreshold;
+}
 
 Direction Path::getDirection(const Position& pos1, const Position& pos2) {
     Direction result = Direction::STAY;
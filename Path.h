@@ -12,19 +12,108 @@
 
 #include <list>
 #include <vector>
+#include <ostream>
+#include <climits>
+
+class StateOverlay;
 
 class Path {
     public:
         typedef std::list<Position> PathType;
 
+        // Answer of query(): what callers need from a path without building it
+        struct Result {
+            Result() : direction(STAY), distance(0), goal(), cancelled(false) {
+
+            }
+
+            bool found() const { return distance > 0; }
+
+            Direction direction;    // first step, STAY if there is no path
+            int distance;           // cells on the path, same as getPath(...).size(): 0 if there is no path
+            Position goal;          // goal cell reached, (-1, -1) if there is no path
+            bool cancelled;         // Limits stopped the search before it finished (nothing found yet), see resume()
+        };
+
+        // Bounds of a query(); the default ones bound nothing
+        struct Limits {
+            Limits() : maxDistance(INT_MAX), flag(NULL), deadline(0.0) {
+
+            }
+
+            int maxDistance;        // longer paths are not searched for; with avoid types this bounds the cost
+                                    // (steps plus penalties), so a found path is never longer either
+            const OmpFlag* flag;    // the search is cancelled once the flag is reset, NULL for none
+            double deadline;        // ... or once get_double_time() passes this, 0 for none
+        };
+
+        enum Engine {
+            SET_ASTAR,      // original std::set/std::map based Graph::AStar, kept for comparison
+            FLAT_ASTAR,     // Graph::FlatAStar on a per-thread reusable workspace, tavern/mine goals without
+                            // avoid types are answered from the per-turn DistanceFields
+            POLICY_ASTAR,   // as FLAT_ASTAR, but searching with the statically dispatched Graph::PolicyAStar; tile goal
+                            // queries run Graph::BucketSearch with avoided cells as step costs instead of heuristic
+                            // inflation, so their paths are the cheapest ones
+            JUMP_POINT,     // as POLICY_ASTAR, but point-to-point queries run Graph::JumpPointSearch
+            BIDIRECTIONAL,  // as POLICY_ASTAR, but point-to-point queries run Graph::BidirectionalSearch
+            CORRIDOR        // as POLICY_ASTAR, but point-to-point queries search the CorridorGraph of the map
+        };
+
     public:
         static PathType getPath(const State& tiles, const Position& start, const Position& end);
         static PathType getPath(const State& tiles, const Position& start, Tile tileType);
         static PathType getPath(const State& tiles, const Position& start, const std::vector<Tile>& tileTypes);
         static PathType getPath(const State& tiles, const Position& start, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes);
 
+        // Same searches as getPath without building the path; it is written to 'path' only when given
+        static Result query(const State& state, const Position& start, const Position& end, std::vector<Position>* path = NULL);
+        static Result query(const State& state, const Position& start, const std::vector<Tile>& goalTypes,
+                            const std::vector<Tile>& avoidTypes = std::vector<Tile>(), std::vector<Position>* path = NULL);
+
+        // Same queries within 'limits'. They run on PolicyAStar (point-to-point) or BucketSearch (tile goals) whatever
+        // the engine, as those can stop early; tile goals answered by DistanceFields are only checked against the bound
+        static Result query(const State& state, const Position& start, const Position& end, const Limits& limits,
+                            std::vector<Position>* path = NULL);
+        static Result query(const State& state, const Position& start, const std::vector<Tile>& goalTypes,
+                            const std::vector<Tile>& avoidTypes, const Limits& limits, std::vector<Position>* path = NULL);
+
+        // Continues the last cancelled query of the calling thread on 'state' within new limits; when another search
+        // ran in between it starts that query over. A Result with nothing found if there is no such query
+        static Result resume(const State& state, const Limits& limits, std::vector<Position>* path = NULL);
+
+        // Same queries on 'state' with the heroes and mine owners of the overlay, for what-if questions without a
+        // copy of the state. They run on PolicyAStar / BucketSearch (JumpPointSearch on JUMP_POINT) whatever the
+        // engine, bypass DistanceFields and the cache, and allocate nothing once the board was searched before
+        static Result query(const StateOverlay& overlay, const Position& start, const Position& end, std::vector<Position>* path = NULL);
+        static Result query(const StateOverlay& overlay, const Position& start, const std::vector<Tile>& goalTypes,
+                            const std::vector<Tile>& avoidTypes = std::vector<Tile>(), std::vector<Position>* path = NULL);
+
+        static void setEngine(Engine engine);
+        static Engine getEngine();
+
+        // Boards with more cells than this (64 * 64 by default) answer point-to-point queries of every engine but
+        // SET_ASTAR and FLAT_ASTAR hierarchically: a route over the portals of the SectorGraph, refined sector by
+        // sector; those paths may be a few steps longer than the shortest ones
+        static void setHierarchicalThreshold(int cells);
+        static int getHierarchicalThreshold();
+
+        // Length of getPath(state, start, goalTypes) or -1 if there is no path
+        static int getDistance(const State& state, const Position& start, const std::vector<Tile>& goalTypes);
+
         static Direction getDirection(const Position& pos1, const Position& pos2);
 
+        // Bit set of tile types (bit 1 << type), so goal and availability tests are a single AND
+        static int getTileMask(const std::vector<Tile>& tileTypes);
+
+        // Appends positions of every tile of the given types (heroes, taverns, mines) in 'state'
+        static void getTilePositions(const State& state, const std::vector<Tile>& tileTypes, std::vector<Position>& positions);
+        static void getTilePositions(const StateOverlay& overlay, const std::vector<Tile>& tileTypes, std::vector<Position>& positions);
+
+        // Times the engines on the given state (bypassing DistanceFields and the cache) and prints, for tile goal
+        // and point-to-point queries separately, us/query and expansions/query; the last row is POLICY_ASTAR with
+        // every point-to-point query answered hierarchically
+        static void benchmark(const State& state, std::ostream& os);
+
     private:
 
 };
@@ -0,0 +1,90 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "PathCache.h"
+
+static thread_local unsigned long cacheHits = 0;
+static thread_local unsigned long cacheMisses = 0;
+
+/*** PathCache::Key ***/
+
+PathCache::Key::Key(int engine, const Position& start, const Position& end)
+        : engine(engine), threshold(Path::getHierarchicalThreshold()), start(start), end(end), goalMask(0), avoidMask(0) {
+
+}
+
+PathCache::Key::Key(int engine, const Position& start, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes)
+        : engine(engine), threshold(Path::getHierarchicalThreshold()), start(start), end(-1, -1), goalMask(Path::getTileMask(goalTypes)), avoidMask(Path::getTileMask(avoidTypes)) {
+
+}
+
+bool PathCache::Key::operator<(const Key& key) const {
+    if(engine != key.engine) return engine < key.engine;
+    if(threshold != key.threshold) return threshold < key.threshold;
+    if(start != key.start) return start < key.start;
+    if(end != key.end) return end < key.end;
+    if(goalMask != key.goalMask) return goalMask < key.goalMask;
+    return avoidMask < key.avoidMask;
+}
+
+/*** PathCache ***/
+
+PathCache::PathCache() : _hash(0) {
+
+}
+
+PathCache& PathCache::get(const State& state) {
+    static thread_local PathCache cache;
+
+    Hash stateHash = hash_value(state);
+    if(stateHash != cache._hash) {
+        cache._paths.clear();
+        cache._results.clear();
+        cache._hash = stateHash;
+    }
+
+    return cache;
+}
+
+const PathCache::PathType* PathCache::find(const Key& key) {
+    std::map<Key, PathType>::const_iterator it = _paths.find(key);
+
+    if(it == _paths.end()) {
+        ++cacheMisses;
+        return NULL;
+    }
+
+    ++cacheHits;
+    return &it->second;
+}
+
+const PathCache::PathType& PathCache::insert(const Key& key, const PathType& path) {
+    return (_paths[key] = path);
+}
+
+const PathCache::ResultType* PathCache::findResult(const Key& key) {
+    std::map<Key, ResultType>::const_iterator it = _results.find(key);
+
+    if(it == _results.end()) {
+        ++cacheMisses;
+        return NULL;
+    }
+
+    ++cacheHits;
+    return &it->second;
+}
+
+const PathCache::ResultType& PathCache::insertResult(const Key& key, const ResultType& result) {
+    return (_results[key] = result);
+}
+
+unsigned long PathCache::getHits() {
+    return cacheHits;
+}
+
+unsigned long PathCache::getMisses() {
+    return cacheMisses;
+}
@@ -0,0 +1,68 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef PATHCACHE_H_INCLUDED
+#define PATHCACHE_H_INCLUDED
+
+#include "Path.h"
+
+#include <map>
+#include <vector>
+
+/**
+ * Results of Path queries (full paths and Path::query answers) made during one turn.
+ *
+ * Strategies evaluated in the same turn ask the same questions (path to the tavern, to every
+ * hero, ...) many times; each query is answered by a search only once, repeats are a lookup.
+ * Entries are keyed by the query (start, goal, avoided tiles, engine, hierarchical threshold)
+ * and dropped as soon as the state hash changes.
+ */
+class PathCache {
+    public:
+        typedef Path::PathType PathType;
+        typedef Path::Result ResultType;
+
+        struct Key {
+            // Query for a single goal cell
+            Key(int engine, const Position& start, const Position& end);
+            // Query for any tile of 'goalTypes', avoiding 'avoidTypes'
+            Key(int engine, const Position& start, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes);
+
+            bool operator<(const Key& key) const;
+
+            int engine;
+            int threshold;      // Path::getHierarchicalThreshold() at the query, it decides how large boards are searched
+            Position start;
+            Position end;       // (-1, -1) for tile queries
+            int goalMask;
+            int avoidMask;
+        };
+
+    public:
+        // Cache of the calling thread, emptied when called with a state of another hash (a new turn)
+        static PathCache& get(const State& state);
+
+        // Cached result or null; counts a hit or a miss
+        const PathType* find(const Key& key);
+        const PathType& insert(const Key& key, const PathType& path);
+
+        // Same for Path::query answers, kept apart from full paths
+        const ResultType* findResult(const Key& key);
+        const ResultType& insertResult(const Key& key, const ResultType& result);
+
+        // Totals of the calling thread since start
+        static unsigned long getHits();
+        static unsigned long getMisses();
+
+    private:
+        PathCache();
+
+        Hash _hash;
+        std::map<Key, PathType> _paths;
+        std::map<Key, ResultType> _results;
+};
+
+#endif
@@ -0,0 +1,277 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "PathSurvey.h"
+#include "DangerField.h"
+
+#include <climits>
+#include <algorithm>
+
+const int PathSurvey::OWNERS;
+
+static const Direction neighbourDirections[4] = {
+    NORTH, SOUTH, EAST, WEST    // order of MapIndex::getNeighbours
+};
+
+/*** Sweep memory reused by consecutive surveys of the calling thread ***/
+struct SurveyWorkspace {
+    SurveyWorkspace() : generation(0) {
+
+    }
+
+    void reset(int cells) {
+        if(static_cast<int>(stamp.size()) != cells) {
+            stamp.assign(cells, 0);
+            closed.assign(cells, 0);
+            danger.assign(cells, 0);
+            steps.assign(cells, 0);
+            firstStep.assign(cells, 0);
+            generation = 0;
+        }
+
+        if(++generation == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            std::fill(closed.begin(), closed.end(), 0);
+            generation = 1;
+        }
+
+        queue.clear();
+        seeds.clear();
+        nextSeeds.clear();
+    }
+
+    // True if (cellDanger, cellSteps) improves on what 'index' already has in this sweep
+    bool improve(int index, int cellDanger, int cellSteps, int cellFirstStep) {
+        if(stamp[index] == generation && (danger[index] < cellDanger || (danger[index] == cellDanger && steps[index] <= cellSteps))) {
+            return false;
+        }
+
+        stamp[index] = generation;
+        danger[index] = cellDanger;
+        steps[index] = cellSteps;
+        firstStep[index] = cellFirstStep;
+        return true;
+    }
+
+    unsigned int generation;
+    std::vector<unsigned int> stamp;    // danger/steps/firstStep valid in this sweep
+    std::vector<unsigned int> closed;   // settled in this sweep
+    std::vector<int> danger;
+    std::vector<int> steps;
+    std::vector<int> firstStep;
+
+    std::vector<int> queue;             // cells of the current danger level, by steps
+    std::vector<int> seeds;             // cells entering the current level from the previous one, by steps
+    std::vector<int> nextSeeds;
+};
+
+PathSurvey::PathSurvey(const State& state, const Position& start, const std::vector<Tile>& goalTypes, const std::vector<Tile>& avoidTypes, int targets)
+        : _targets(targets), _goalMask(0), _settled(0) {
+    for(int i = 0; i < 4; ++i) {
+        _heroOrder[i] = INT_MAX;
+    }
+
+    for(Tile t : goalTypes) {
+        if(t >= HERO1 && t <= HERO4 && state.heroes[t - HERO1].position == start) {
+            continue; // hero standing on the start cell is not a target
+        }
+
+        _goalMask |= (1 << t);
+    }
+
+    // Targets that can be settled at all, the sweep ends early once it has all of them
+    int wanted = 0;
+    for(int t = HERO1; t <= MINE4; ++t) {
+        if(_goalMask & (1 << t)) {
+            wanted += _getAvailable(state, (Tile)t);
+        }
+    }
+
+    _sweep(state, start, avoidTypes, wanted);
+}
+
+Path::Result PathSurvey::getNearest(const std::vector<Tile>& goalTypes) const {
+    Path::Result result;
+    int bestOrder = INT_MAX;
+
+    for(Tile t : goalTypes) {
+        const Path::Result* candidate = NULL;
+        int order = INT_MAX;
+
+        switch(t) {
+            case HERO1:
+            case HERO2:
+            case HERO3:
+            case HERO4:
+                candidate = &_heroes[t - HERO1];
+                order = _heroOrder[t - HERO1];
+                break;
+            case TAVERN:
+                if(!_taverns.empty()) {
+                    candidate = &_taverns.front();
+                    order = _tavernOrder.front();
+                }
+                break;
+            case MINE:
+            case MINE1:
+            case MINE2:
+            case MINE3:
+            case MINE4:
+                if(!_mines[t - MINE].empty()) {
+                    candidate = &_mines[t - MINE].front();
+                    order = _mineOrder[t - MINE].front();
+                }
+                break;
+            default: break;
+        }
+
+        if(candidate && order < bestOrder) {
+            result = *candidate;
+            bestOrder = order;
+        }
+    }
+
+    return result;
+}
+
+// BFS by steps inside one danger level, merged with the cells entering the level from the
+// previous one (already sorted by steps); cells reached through a dangerous cell wait for the
+// next level, so cells settle in order of (danger, steps)
+void PathSurvey::_sweep(const State& state, const Position& start, const std::vector<Tile>& avoidTypes, int wanted) {
+    static thread_local SurveyWorkspace ws;
+
+    const MapIndex& mapIndex = *state.get_map_index();
+    const DangerField* dangerField = avoidTypes.empty() ? NULL : &DangerField::get(state, avoidTypes);
+
+    int startIndex = mapIndex.getIndex(start);
+    if(startIndex < 0 || wanted == 0) {
+        return;
+    }
+
+    int heroIndices[4];
+    for(int i = 0; i < 4; ++i) {
+        heroIndices[i] = mapIndex.getIndex(state.heroes[i].position);
+    }
+
+    ws.reset(mapIndex.getWidth() * mapIndex.getHeight());
+    ws.improve(startIndex, 0, 0, -1);
+    ws.queue.push_back(startIndex);
+
+    for(int level = 0; !ws.queue.empty() || !ws.seeds.empty(); ++level) {
+        std::size_t head = 0;
+        std::size_t seed = 0;
+
+        while(head < ws.queue.size() || seed < ws.seeds.size()) {
+            int current;
+            if(seed < ws.seeds.size() && (head == ws.queue.size() || ws.steps[ws.seeds[seed]] < ws.steps[ws.queue[head]])) {
+                current = ws.seeds[seed++];
+            } else {
+                current = ws.queue[head++];
+            }
+
+            if(ws.closed[current] == ws.generation || ws.danger[current] != level) {
+                continue; // settled earlier or improved since it was queued
+            }
+            ws.closed[current] = ws.generation;
+
+            if(current != startIndex && (!mapIndex.isPassable(current) || current == heroIndices[0] || current == heroIndices[1] ||
+                                         current == heroIndices[2] || current == heroIndices[3])) {
+                Position position = mapIndex.getPosition(current);
+                Path::Result result;
+                result.direction = neighbourDirections[ws.firstStep[current]];
+                result.distance = ws.steps[current];
+                result.goal = position;
+                _addTarget(state.get_tile_from_background(position), result);
+
+                if(_settled == wanted) {
+                    return;
+                }
+                continue; // goals are never walked through
+            }
+
+            const int* neighbours = mapIndex.getNeighbours(current);
+            for(int direction = 0; direction < 4; ++direction) {
+                int neighbour = neighbours[direction];
+                if(neighbour < 0 || ws.closed[neighbour] == ws.generation) {
+                    continue;
+                }
+
+                int neighbourDanger = level + ((dangerField && dangerField->isDangerous(neighbour)) ? 1 : 0);
+                int firstStep = (current == startIndex) ? direction : ws.firstStep[current];
+
+                if(ws.improve(neighbour, neighbourDanger, ws.steps[current] + 1, firstStep)) {
+                    (neighbourDanger == level ? ws.queue : ws.nextSeeds).push_back(neighbour);
+                }
+            }
+        }
+
+        ws.queue.clear();
+        ws.seeds.swap(ws.nextSeeds);
+        ws.nextSeeds.clear();
+    }
+}
+
+void PathSurvey::_addTarget(Tile tile, const Path::Result& result) {
+    if(!(_goalMask & (1 << tile))) {
+        return;
+    }
+
+    switch(tile) {
+        case HERO1:
+        case HERO2:
+        case HERO3:
+        case HERO4:
+            if(!_heroes[tile - HERO1].found()) {
+                _heroes[tile - HERO1] = result;
+                _heroOrder[tile - HERO1] = _settled++;
+            }
+            break;
+        case TAVERN:
+            if(static_cast<int>(_taverns.size()) < _targets) {
+                _taverns.push_back(result);
+                _tavernOrder.push_back(_settled++);
+            }
+            break;
+        case MINE:
+        case MINE1:
+        case MINE2:
+        case MINE3:
+        case MINE4:
+            if(static_cast<int>(_mines[tile - MINE].size()) < _targets) {
+                _mines[tile - MINE].push_back(result);
+                _mineOrder[tile - MINE].push_back(_settled++);
+            }
+            break;
+        default: break;
+    }
+}
+
+int PathSurvey::_getAvailable(const State& state, Tile tile) const {
+    const MapIndex& mapIndex = *state.get_map_index();
+
+    switch(tile) {
+        case HERO1:
+        case HERO2:
+        case HERO3:
+        case HERO4:
+            return 1;
+        case TAVERN:
+            return std::min<int>(_targets, mapIndex.getTaverns().size());
+        case MINE1:
+        case MINE2:
+        case MINE3:
+        case MINE4:
+            return std::min<int>(_targets, state.heroes[tile - MINE1].mine_positions.size());
+        case MINE: {
+            int neutralMines = mapIndex.getMineCount();
+            for(const State::Hero& hero : state.heroes) {
+                neutralMines -= hero.mine_positions.size();
+            }
+            return std::min(_targets, neutralMines);
+        }
+        default: return 0;
+    }
+}
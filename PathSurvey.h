@@ -0,0 +1,59 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef PATHSURVEY_H_INCLUDED
+#define PATHSURVEY_H_INCLUDED
+
+#include "Path.h"
+
+#include <vector>
+
+/**
+ * Paths from one start cell to the points of interest a strategy asks about, found by a single
+ * sweep: any of the heroes, the nearest taverns and the nearest mines of each requested owner.
+ *
+ * Cells are settled in order of (dangerous cells entered, steps), where dangerous cells are
+ * those of DangerField for the avoided tile types; without avoided tiles this is a plain BFS.
+ * A strategy scoring several goals from the hero position asks one survey instead of running
+ * a search per goal.
+ */
+class PathSurvey {
+    public:
+        // Collects targets of 'goalTypes' (heroes, taverns, mines of the given owners), keeping the 'targets'
+        // nearest taverns and the 'targets' nearest mines of every requested owner tile (MINE, MINE1..MINE4);
+        // the sweep stops once all of them are settled
+        PathSurvey(const State& state, const Position& start, const std::vector<Tile>& goalTypes,
+                   const std::vector<Tile>& avoidTypes = std::vector<Tile>(), int targets = 1);
+
+        // Results are as from Path::query (not found if the target can't be reached)
+        const Path::Result& getHero(int heroIndex) const { return _heroes[heroIndex]; }
+        // Nearest first, at most 'targets' entries each
+        const std::vector<Path::Result>& getTaverns() const { return _taverns; }
+        // Mines of one owner tile (MINE for neutral ones, MINE1..MINE4), empty if it wasn't requested
+        const std::vector<Path::Result>& getMines(Tile owner) const { return _mines[owner - MINE]; }
+
+        // Nearest target of any of the given requested tile types
+        Path::Result getNearest(const std::vector<Tile>& goalTypes) const;
+
+    private:
+        static const int OWNERS = 5;        // MINE, MINE1..MINE4
+
+        void _sweep(const State& state, const Position& start, const std::vector<Tile>& avoidTypes, int wanted);
+        void _addTarget(Tile tile, const Path::Result& result);
+        int _getAvailable(const State& state, Tile tile) const;
+
+        int _targets;
+        int _goalMask;                      // bit per requested tile type
+        Path::Result _heroes[4];
+        std::vector<Path::Result> _taverns;
+        std::vector<Path::Result> _mines[OWNERS];
+        int _heroOrder[4];                  // settle order of targets, to compare different kinds
+        std::vector<int> _tavernOrder;
+        std::vector<int> _mineOrder[OWNERS];
+        int _settled;                       // targets settled so far
+};
+
+#endif
@@ -0,0 +1,273 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "Route.h"
+
+#include <climits>
+#include <cstdlib>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+
+/*** Distance of cells that can't reach a goal, low enough to add heuristics to ***/
+static const int INFINITE = INT_MAX / 4;
+
+Route::Route() : _goalMask(0), _valid(false), _height(0), _start(-1), _keyModifier(0), _expansions(0) {
+
+}
+
+Route::Route(const std::vector<Tile>& goalTypes) : Route() {
+    setGoal(goalTypes);
+}
+
+void Route::setGoal(const std::vector<Tile>& goalTypes) {
+    if(_valid && goalTypes == _goalTypes) {
+        return;
+    }
+
+    _goalTypes = goalTypes;
+    _goalMask = Path::getTileMask(goalTypes);
+    _valid = false;
+}
+
+Path::Result Route::query(const State& state, const Position& start) {
+    Path::Result result;
+    const MapIndex::Pointer& mapIndex = state.get_map_index();
+
+    int startIndex = mapIndex->getIndex(start);
+    if(startIndex < 0) {
+        return result;
+    }
+
+    _expansions = 0;
+
+    if(!_valid || mapIndex != _mapIndex) {
+        _mapIndex = mapIndex;
+        _start = startIndex;
+        _reset(state);
+    } else {
+        // The start moved: keys already in the queue become too low by at most the distance walked
+        int previousStart = _start;
+        if(startIndex != _start) {
+            Position from = _mapIndex->getPosition(_start);
+
+            _keyModifier += std::abs(from.x - start.x) + std::abs(from.y - start.y);
+            _start = startIndex;
+        }
+
+        // Only heroes and mine owners change during a game
+        int previousHeroes[4];
+        for(int i = 0; i < 4; ++i) {
+            previousHeroes[i] = _heroCells[i];
+            _heroCells[i] = _mapIndex->getIndex(state.heroes[i].position);
+        }
+
+        _setType(state, previousStart);
+        _setType(state, _start);
+        for(int i = 0; i < 4; ++i) {
+            _setType(state, previousHeroes[i]);
+            _setType(state, _heroCells[i]);
+        }
+
+        for(int i = 0; i < 4; ++i) {
+            const PositionsSet& mines = state.heroes[i].mine_positions;
+            if(mines == _heroMines[i]) {
+                continue;
+            }
+
+            std::vector<Position> changed;
+            std::set_symmetric_difference(mines.begin(), mines.end(), _heroMines[i].begin(), _heroMines[i].end(),
+                                          std::back_inserter(changed));
+            for(const Position& mine : changed) {
+                _setType(state, _mapIndex->getIndex(mine));
+            }
+            _heroMines[i] = mines;
+        }
+    }
+
+    _repair();
+
+    if(_g[_start] >= INFINITE) {
+        return result;
+    }
+
+    // Down the distances to the goal; the first step gives the direction
+    int current = _start;
+    for(int step = 0; step < _g[_start] && _types[current] != GOAL; ++step) {
+        const int* neighbours = _mapIndex->getNeighbours(current);
+        int next = -1;
+
+        for(int direction = 0; direction < 4; ++direction) {
+            int neighbour = neighbours[direction];
+            if(neighbour >= 0 && _types[neighbour] != BLOCKED && (next < 0 || _g[neighbour] < _g[next])) {
+                next = neighbour;
+            }
+        }
+
+        if(current == _start) {
+            result.direction = Path::getDirection(start, _mapIndex->getPosition(next));
+        }
+        current = next;
+    }
+
+    result.distance = _g[_start];
+    result.goal = _mapIndex->getPosition(current);
+
+    return result;
+}
+
+void Route::_reset(const State& state) {
+    const int cells = _mapIndex->getWidth() * _mapIndex->getHeight();
+    _height = _mapIndex->getHeight();
+    _keyModifier = 0;
+
+    _heroCells.resize(4);
+    for(int i = 0; i < 4; ++i) {
+        _heroCells[i] = _mapIndex->getIndex(state.heroes[i].position);
+        _heroMines[i] = state.heroes[i].mine_positions;
+    }
+
+    _types.resize(cells);
+    _g.assign(cells, INFINITE);
+    _rhs.assign(cells, INFINITE);
+    _open.assign(cells, false);
+    _keys.resize(cells);
+    _heap.clear();
+
+    for(int index = 0; index < cells; ++index) {
+        _types[index] = _getType(state, index);
+        if(_types[index] == GOAL) {
+            _rhs[index] = 0;
+            _push(index);
+        }
+    }
+
+    _valid = true;
+}
+
+Route::CellType Route::_getType(const State& state, int index) const {
+    // The hero stands on the start, but walks from it
+    if(index == _start) {
+        return WALKABLE;
+    }
+
+    // EMPTY on the background and no hero on it, without looking the tile up
+    if(_mapIndex->isPassable(index) && !(_goalMask & (1 << EMPTY)) &&
+       std::find(_heroCells.begin(), _heroCells.end(), index) == _heroCells.end()) {
+        return WALKABLE;
+    }
+
+    Tile tile = state.get_tile_from_background_border_check(_mapIndex->getPosition(index));
+    if(_goalMask & (1 << tile)) {
+        return GOAL;
+    }
+
+    return (tile == EMPTY) ? WALKABLE : BLOCKED;
+}
+
+void Route::_setType(const State& state, int index) {
+    if(index < 0) {
+        return;
+    }
+
+    CellType type = _getType(state, index);
+    if(type != _types[index]) {
+        _types[index] = type;
+        _updateCell(index);
+    }
+}
+
+Route::Key Route::_getKey(int index) const {
+    int distance = std::min(_g[index], _rhs[index]);
+
+    return Key(distance + _getHeuristic(index) + _keyModifier, distance);
+}
+
+int Route::_getHeuristic(int index) const {
+    return std::abs(index / _height - _start / _height) + std::abs(index % _height - _start % _height);
+}
+
+void Route::_updateCell(int index) {
+    if(_types[index] == GOAL) {
+        _rhs[index] = 0;
+    } else if(_types[index] == BLOCKED) {
+        _rhs[index] = INFINITE;
+    } else {
+        const int* neighbours = _mapIndex->getNeighbours(index);
+        int best = INFINITE;
+
+        for(int direction = 0; direction < 4; ++direction) {
+            if(neighbours[direction] >= 0 && _g[neighbours[direction]] + 1 < best) {
+                best = _g[neighbours[direction]] + 1;
+            }
+        }
+        _rhs[index] = best;
+    }
+
+    if(_g[index] != _rhs[index]) {
+        _push(index);
+    } else {
+        _open[index] = false;
+    }
+}
+
+void Route::_push(int index) {
+    // Stale entries pile up with re-keyed cells, so the heap is rebuilt from the open cells once in a while
+    if(_heap.size() > 4 * _g.size()) {
+        _heap.clear();
+        for(std::size_t cell = 0; cell < _open.size(); ++cell) {
+            if(_open[cell]) {
+                _heap.push_back(std::make_pair(_keys[cell], static_cast<int>(cell)));
+            }
+        }
+        std::make_heap(_heap.begin(), _heap.end(), std::greater<std::pair<Key, int>>());
+    }
+
+    _keys[index] = _getKey(index);
+    _open[index] = true;
+    _heap.push_back(std::make_pair(_keys[index], index));
+    std::push_heap(_heap.begin(), _heap.end(), std::greater<std::pair<Key, int>>());
+}
+
+void Route::_repair() {
+    while(true) {
+        while(!_heap.empty() && (!_open[_heap.front().second] || _heap.front().first != _keys[_heap.front().second])) {
+            std::pop_heap(_heap.begin(), _heap.end(), std::greater<std::pair<Key, int>>());
+            _heap.pop_back();
+        }
+
+        if(_heap.empty() || (!(_heap.front().first < _getKey(_start)) && _g[_start] == _rhs[_start])) {
+            break;
+        }
+
+        const Key key = _heap.front().first;
+        const int current = _heap.front().second;
+        std::pop_heap(_heap.begin(), _heap.end(), std::greater<std::pair<Key, int>>());
+        _heap.pop_back();
+        _open[current] = false;
+        ++_expansions;
+
+        const Key currentKey = _getKey(current);
+        if(key < currentKey) {
+            _push(current);
+            continue;
+        }
+
+        if(_g[current] > _rhs[current]) {
+            _g[current] = _rhs[current];
+        } else {
+            _g[current] = INFINITE;
+            _updateCell(current);
+        }
+
+        const int* neighbours = _mapIndex->getNeighbours(current);
+        for(int direction = 0; direction < 4; ++direction) {
+            if(neighbours[direction] >= 0) {
+                _updateCell(neighbours[direction]);
+            }
+        }
+    }
+}
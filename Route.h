@@ -0,0 +1,83 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef ROUTE_H_INCLUDED
+#define ROUTE_H_INCLUDED
+
+#include "Path.h"
+
+#include <vector>
+#include <utility>
+
+/**
+ * Path to the nearest tile of the given types kept from one turn to the next (D* Lite).
+ *
+ * The search runs backwards, from all goal tiles towards the hero, and its distances stay
+ * in the route. On the next query only the cells that changed since the last one (cells
+ * heroes left or entered, mines that changed owners) are updated and just the distances
+ * depending on them are repaired, so a route that is still mostly valid costs a small part
+ * of a new search. The hero walking along the route moves the start, which D* Lite handles
+ * without repairs.
+ *
+ * Same rules as Path::query(state, start, goalTypes): only EMPTY cells are walked through
+ * (heroes block their cells), the goal is any tile of the given types. One route serves one
+ * map; another map or other goal types start a new search.
+ *
+ * Goals DistanceFields has fields for (taverns, mines) are served faster by Path::query; a
+ * route pays off for the goal sets the fields can't answer, e.g. heroes.
+ */
+class Route {
+    public:
+        Route();
+        explicit Route(const std::vector<Tile>& goalTypes);
+
+        // Starts a new search on the next query, unless the goal types are the same
+        void setGoal(const std::vector<Tile>& goalTypes);
+        const std::vector<Tile>& getGoal() const { return _goalTypes; }
+
+        // Same distance as Path::query(state, start, getGoal()), repairing the route of the previous query
+        Path::Result query(const State& state, const Position& start);
+
+        // Cells expanded by the last query (a new search expands every cell it reaches)
+        unsigned int getExpansions() const { return _expansions; }
+
+    private:
+        typedef std::pair<int, int> Key;
+
+        enum CellType { BLOCKED, WALKABLE, GOAL };
+
+        void _reset(const State& state);
+        CellType _getType(const State& state, int index) const;
+        void _setType(const State& state, int index);
+
+        Key _getKey(int index) const;
+        int _getHeuristic(int index) const;
+        void _updateCell(int index);
+        void _push(int index);
+        void _repair();
+
+        std::vector<Tile> _goalTypes;
+        int _goalMask;
+        bool _valid;
+
+        MapIndex::Pointer _mapIndex;        // held, so a new map can't take the address of the old one
+        int _height;
+        int _start;
+        int _keyModifier;
+        std::vector<int> _heroCells;        // heroes of the last query
+        PositionsSet _heroMines[4];         // mines of the heroes at the last query
+
+        std::vector<unsigned char> _types;
+        std::vector<int> _g;
+        std::vector<int> _rhs;
+        std::vector<bool> _open;
+        std::vector<Key> _keys;                     // key of the cell while it is open
+        std::vector<std::pair<Key, int>> _heap;     // (key, cell), entries of closed or re-keyed cells are skipped
+
+        unsigned int _expansions;
+};
+
+#endif
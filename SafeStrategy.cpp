@@ -36,22 +36,22 @@ SafeStrategy::SafeStrategy(const Game& game) : Strategy(game) {
 Direction SafeStrategy::getMove() {
     int health = _game.state.heroes[_heroNumber].life;
 
-    Path::PathType path1 = Path::getPath(_game.state, _game.state.heroes[_heroNumber].position, _goal, _avoid);
-    Path::PathType path2 = Path::getPath(_game.state, _game.state.heroes[_heroNumber].position, _tavern, _avoid);
+    Path::Result path1 = Path::query(_game.state, _game.state.heroes[_heroNumber].position, _goal, _avoid);
+    Path::Result path2 = Path::query(_game.state, _game.state.heroes[_heroNumber].position, _tavern, _avoid);
 
-    Path::PathType path;
+    Path::Result path;
 
-    if(health-(int)path1.size() < 50) {
+    if(health-path1.distance < 50) {
         path = path2;
     } else {
         path = path1;
     }
 
-    if(path.size() == 0) {
+    if(!path.found()) {
         return STAY;
     }
 
-    return Path::getDirection(_game.state.heroes[_heroNumber].position, path.front());
+    return path.direction;
 }
 
 Tile SafeStrategy::getHeroFromIndex(int index) {
@@ -0,0 +1,502 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "SectorGraph.h"
+#include "MapIndex.h"
+
+#include <climits>
+#include <cstdlib>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+const int SectorGraph::SIZE;
+
+/*** Abstract search memory reused by consecutive queries of the calling thread ***/
+struct SectorWorkspace {
+    SectorWorkspace() : generation(0) {
+
+    }
+
+    void reset(int portals) {
+        if(static_cast<int>(stamp.size()) != portals) {
+            stamp.assign(portals, 0);
+            closed.assign(portals, 0);
+            goalStamp.assign(portals, 0);
+            distance.assign(portals, 0);
+            bound.assign(portals, 0);
+            parent.assign(portals, -1);
+            goalCost.assign(portals, 0);
+            goalTarget.assign(portals, 0);
+            generation = 0;
+        }
+
+        if(++generation == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            std::fill(closed.begin(), closed.end(), 0);
+            std::fill(goalStamp.begin(), goalStamp.end(), 0);
+            generation = 1;
+        }
+
+        blocked.clear();
+        sources.clear();
+        targets.clear();
+        heap.clear();
+        route.clear();
+        cells.clear();
+    }
+
+    bool hasDistance(int node) const { return stamp[node] == generation; }
+    bool isClosed(int node) const { return closed[node] == generation; }
+    bool hasGoal(int node) const { return goalStamp[node] == generation; }
+
+    void setGoal(int node, int cost, int target) {
+        if(!hasGoal(node) || cost < goalCost[node]) {
+            goalStamp[node] = generation;
+            goalCost[node] = cost;
+            goalTarget[node] = target;
+        }
+    }
+
+    unsigned int generation;
+    std::vector<unsigned int> stamp;        // distance, bound and parent valid in this query
+    std::vector<unsigned int> closed;
+    std::vector<unsigned int> goalStamp;    // goalCost and goalTarget valid in this query
+    std::vector<int> distance;
+    std::vector<int> bound;                 // A* bound to the goal, computed once per query
+    std::vector<int> parent;                // previous portal, -1 - source for portals reached from a source
+    std::vector<int> goalCost;              // cells from the portal to the goal inside the goal's sector
+    std::vector<int> goalTarget;            // target the goalCost leads to
+
+    std::vector<int> blocked;
+    std::vector<std::pair<int, int>> sources;   // (cell, cost): first cells walked through from the start
+    std::vector<std::pair<int, int>> targets;   // (cell, cost): last cells walked through before the goal
+    std::vector<std::pair<int, int>> heap;      // (f, portal)
+    std::vector<int> route;                     // portals of the path found, from the goal back to the start
+    std::vector<int> cells;                     // the path when the caller doesn't want it
+};
+
+SectorGraph::SectorGraph() : _width(0), _height(0), _sectorsX(0), _sectorsY(0) {
+
+}
+
+void SectorGraph::compute(const MapIndex& mapIndex) {
+    _width = mapIndex.getWidth();
+    _height = mapIndex.getHeight();
+    _sectorsX = (_width + SIZE - 1) / SIZE;
+    _sectorsY = (_height + SIZE - 1) / SIZE;
+
+    const int cells = _width * _height;
+    const int sectors = getSectorCount();
+
+    _tiledPassable.assign(sectors * SIZE * SIZE, 0);
+    for(int index = 0; index < cells; ++index) {
+        _tiledPassable[_getTiled(index / _height, index % _height)] = mapIndex.isPassable(index);
+    }
+
+    // Entrances: runs of EMPTY cell pairs across one sector border, one portal pair in the middle
+    // of a short run and one at each end of a long one
+    std::vector<std::pair<int, int>> transitions;
+    std::vector<std::pair<int, int>> run;
+    auto flush = [&]() {
+        if(run.size() > 5) {
+            transitions.push_back(run.front());
+            transitions.push_back(run.back());
+        } else if(!run.empty()) {
+            transitions.push_back(run[run.size() / 2]);
+        }
+        run.clear();
+    };
+
+    for(int x = SIZE; x < _width; x += SIZE) {
+        for(int y = 0; y < _height; ++y) {
+            if(y % SIZE == 0) {
+                flush();
+            }
+
+            int inner = (x - 1) * _height + y, outer = x * _height + y;
+            if(mapIndex.isPassable(inner) && mapIndex.isPassable(outer)) {
+                run.push_back(std::make_pair(inner, outer));
+            } else {
+                flush();
+            }
+        }
+        flush();
+    }
+
+    for(int y = SIZE; y < _height; y += SIZE) {
+        for(int x = 0; x < _width; ++x) {
+            if(x % SIZE == 0) {
+                flush();
+            }
+
+            int inner = x * _height + y - 1, outer = x * _height + y;
+            if(mapIndex.isPassable(inner) && mapIndex.isPassable(outer)) {
+                run.push_back(std::make_pair(inner, outer));
+            } else {
+                flush();
+            }
+        }
+        flush();
+    }
+
+    // Portals numbered sector by sector
+    _nodeOf.assign(cells, -1);
+    _nodes.clear();
+    for(const std::pair<int, int>& transition : transitions) {
+        for(int cell : { transition.first, transition.second }) {
+            if(_nodeOf[cell] < 0) {
+                _nodeOf[cell] = 0;
+                _nodes.push_back(cell);
+            }
+        }
+    }
+
+    std::sort(_nodes.begin(), _nodes.end(), [this](int lhs, int rhs) {
+        return std::make_pair(getSector(lhs), lhs) < std::make_pair(getSector(rhs), rhs);
+    });
+
+    _sectorBegin.assign(sectors + 1, 0);
+    for(std::size_t node = 0; node < _nodes.size(); ++node) {
+        _nodeOf[_nodes[node]] = node;
+        ++_sectorBegin[getSector(_nodes[node]) + 1];
+    }
+    for(int sector = 0; sector < sectors; ++sector) {
+        _sectorBegin[sector + 1] += _sectorBegin[sector];
+    }
+
+    std::vector<std::vector<Edge>> edges(_nodes.size());
+    for(const std::pair<int, int>& transition : transitions) {
+        int inner = _nodeOf[transition.first], outer = _nodeOf[transition.second];
+        Edge forward = { outer, 1 };
+        Edge backward = { inner, 1 };
+        edges[inner].push_back(forward);
+        edges[outer].push_back(backward);
+    }
+
+    const std::vector<int> noBlocked;
+    for(std::size_t node = 0; node < _nodes.size(); ++node) {
+        _fillSector(_nodes[node], noBlocked, [&](int cell, int distance) {
+            if(distance > 0 && _nodeOf[cell] >= 0) {
+                Edge edge = { _nodeOf[cell], distance };
+                edges[node].push_back(edge);
+            }
+        });
+    }
+
+    _edgeBegin.assign(_nodes.size() + 1, 0);
+    _edges.clear();
+    for(std::size_t node = 0; node < _nodes.size(); ++node) {
+        _edgeBegin[node] = _edges.size();
+        _edges.insert(_edges.end(), edges[node].begin(), edges[node].end());
+    }
+    _edgeBegin[_nodes.size()] = _edges.size();
+}
+
+int SectorGraph::query(const MapIndex& mapIndex, const std::vector<int>& blocked, int start, int goal,
+                       std::vector<int>* path, unsigned int* expansions) const {
+    static thread_local SectorWorkspace workspace;
+    SectorWorkspace& ws = workspace;
+
+    if(path) {
+        path->clear();
+    }
+
+    if(start < 0 || goal < 0) {
+        return 0;
+    }
+
+    // The goal is entered from any cell next to it, even when one of them is WOOD (left out of the adjacency)
+    const Position startPosition = mapIndex.getPosition(start);
+    const Position goalPosition = mapIndex.getPosition(goal);
+    if(start == goal || std::abs(startPosition.x - goalPosition.x) + std::abs(startPosition.y - goalPosition.y) == 1) {
+        if(path) {
+            path->push_back(goal);
+        }
+        return 1;
+    }
+
+    ws.reset(_nodes.size());
+    for(int cell : blocked) {
+        if(cell >= 0 && cell != start && cell != goal) {
+            // A hero on a portal takes its whole entrance out of the graph, though the cells beside it may be open
+            if(_nodeOf[cell] >= 0) {
+                return -1;
+            }
+            ws.blocked.push_back(cell);
+        }
+    }
+
+    auto isWalkable = [&](int cell) {
+        return mapIndex.isPassable(cell) && std::find(ws.blocked.begin(), ws.blocked.end(), cell) == ws.blocked.end();
+    };
+
+    // The start and the goal themselves are walked through only when they are EMPTY
+    if(mapIndex.isPassable(start)) {
+        ws.sources.push_back(std::make_pair(start, 0));
+    } else {
+        const int* neighbours = mapIndex.getNeighbours(start);
+        for(int direction = 0; direction < 4; ++direction) {
+            if(neighbours[direction] >= 0 && isWalkable(neighbours[direction])) {
+                ws.sources.push_back(std::make_pair(neighbours[direction], 1));
+            }
+        }
+    }
+
+    if(mapIndex.isPassable(goal)) {
+        ws.targets.push_back(std::make_pair(goal, 0));
+    } else {
+        const int* neighbours = mapIndex.getNeighbours(goal);
+        for(int direction = 0; direction < 4; ++direction) {
+            if(neighbours[direction] >= 0 && isWalkable(neighbours[direction])) {
+                ws.targets.push_back(std::make_pair(neighbours[direction], 1));
+            }
+        }
+    }
+
+    // A* bound of a portal: Manhattan distance to the goal or, when larger, the landmark bound
+    const LandmarkTable::Target target = mapIndex.getLandmarks().getTarget(goal);
+    auto push = [&](int node, int cost, int parent) {
+        if(!ws.hasDistance(node)) {
+            int cell = _nodes[node];
+            Position position = mapIndex.getPosition(cell);
+            int bound = std::abs(position.x - goalPosition.x) + std::abs(position.y - goalPosition.y);
+            if(cell != goal) {
+                bound = std::max(bound, mapIndex.getLandmarks().getLowerBound(cell, target));
+            }
+
+            ws.stamp[node] = ws.generation;
+            ws.bound[node] = bound;
+        }
+
+        ws.distance[node] = cost;
+        ws.parent[node] = parent;
+        ws.heap.push_back(std::make_pair(cost + ws.bound[node], node));
+        std::push_heap(ws.heap.begin(), ws.heap.end(), std::greater<std::pair<int, int>>());
+    };
+
+    // Portals of the start's sector start the search; targets in the same sector are reached directly
+    int bestCost = INT_MAX, bestNode = -1, bestSource = -1, bestTarget = -1;
+    for(std::size_t source = 0; source < ws.sources.size(); ++source) {
+        const int sourceCost = ws.sources[source].second;
+
+        _fillSector(ws.sources[source].first, ws.blocked, [&](int cell, int distance) {
+            int cost = sourceCost + distance;
+
+            int node = _nodeOf[cell];
+            if(node >= 0 && (!ws.hasDistance(node) || cost < ws.distance[node])) {
+                push(node, cost, -1 - static_cast<int>(source));
+            }
+
+            for(std::size_t t = 0; t < ws.targets.size(); ++t) {
+                if(ws.targets[t].first == cell && cost + ws.targets[t].second < bestCost) {
+                    bestCost = cost + ws.targets[t].second;
+                    bestSource = source;
+                    bestTarget = t;
+                }
+            }
+        });
+    }
+
+    for(std::size_t t = 0; t < ws.targets.size(); ++t) {
+        const int targetCost = ws.targets[t].second;
+
+        _fillSector(ws.targets[t].first, ws.blocked, [&](int cell, int distance) {
+            if(_nodeOf[cell] >= 0) {
+                ws.setGoal(_nodeOf[cell], targetCost + distance, t);
+            }
+        });
+    }
+
+    unsigned int expanded = 0;
+    while(!ws.heap.empty()) {
+        std::pop_heap(ws.heap.begin(), ws.heap.end(), std::greater<std::pair<int, int>>());
+        std::pair<int, int> top = ws.heap.back();
+        ws.heap.pop_back();
+
+        int current = top.second;
+        if(top.first >= bestCost) {
+            break;
+        }
+        if(ws.isClosed(current)) {
+            continue;
+        }
+
+        ws.closed[current] = ws.generation;
+        ++expanded;
+
+        if(ws.hasGoal(current) && ws.distance[current] + ws.goalCost[current] < bestCost) {
+            bestCost = ws.distance[current] + ws.goalCost[current];
+            bestNode = current;
+            bestTarget = ws.goalTarget[current];
+        }
+
+        for(int e = _edgeBegin[current]; e < _edgeBegin[current + 1]; ++e) {
+            const Edge& edge = _edges[e];
+            if(ws.isClosed(edge.to)) {
+                continue;
+            }
+
+            int cost = ws.distance[current] + edge.cost;
+            if(!ws.hasDistance(edge.to) || cost < ws.distance[edge.to]) {
+                push(edge.to, cost, current);
+            }
+        }
+    }
+
+    if(expansions) {
+        *expansions += expanded;
+    }
+
+    // Heroes inside sectors may cut the paths between portals, only the cells can tell whether they cut all of them
+    if(bestCost == INT_MAX) {
+        return ws.blocked.empty() ? 0 : -1;
+    }
+
+    if(bestNode >= 0) {
+        int node = bestNode;
+        for(; node >= 0; node = ws.parent[node]) {
+            ws.route.push_back(node);
+        }
+        bestSource = -1 - node;
+    }
+
+    if(!path) {
+        path = &ws.cells;
+    }
+
+    // Refinement: the source, then the portals one after another and the target, each sector walked on its own
+    const int sourceCell = ws.sources[bestSource].first, targetCell = ws.targets[bestTarget].first;
+    if(sourceCell != start) {
+        path->push_back(sourceCell);
+    }
+
+    int current = sourceCell;
+    for(auto node = ws.route.rbegin(); node != ws.route.rend(); ++node) {
+        int next = _nodes[*node];
+
+        if(getSector(current) != getSector(next)) {
+            path->push_back(next);
+        } else if(!_walkSector(current, next, ws.blocked, *path)) {
+            path->clear();
+            return -1;
+        }
+        current = next;
+    }
+
+    // The last leg was searched with the heroes, so it can't fail
+    _walkSector(current, targetCell, ws.blocked, *path);
+    if(targetCell != goal) {
+        path->push_back(goal);
+    }
+
+    return path->size();
+}
+
+template<typename Visitor>
+void SectorGraph::_fillSector(int source, const std::vector<int>& blocked, const Visitor& visitor) const {
+    static const int moves[4][2] = {
+        { -1,  0 }, {  1,  0 }, {  0,  1 }, {  0, -1 }
+    };
+    static thread_local std::vector<int> distances;
+    static thread_local std::vector<int> queue;
+
+    const int x0 = (source / _height) / SIZE * SIZE, y0 = (source % _height) / SIZE * SIZE;
+    const unsigned char* passable = &_tiledPassable[_getTiled(x0, y0)];
+
+    distances.assign(SIZE * SIZE, -1);
+    queue.clear();
+
+    int local = (source / _height - x0) * SIZE + (source % _height - y0);
+    distances[local] = 0;
+    queue.push_back(local);
+
+    for(std::size_t head = 0; head < queue.size(); ++head) {
+        local = queue[head];
+        const int lx = local / SIZE, ly = local % SIZE;
+        visitor((x0 + lx) * _height + (y0 + ly), distances[local]);
+
+        for(const int* move : moves) {
+            int nx = lx + move[0], ny = ly + move[1];
+            if(nx < 0 || ny < 0 || nx >= SIZE || ny >= SIZE) {
+                continue;
+            }
+
+            int next = nx * SIZE + ny;
+            if(distances[next] >= 0 || !passable[next]) {
+                continue;
+            }
+
+            int cell = (x0 + nx) * _height + (y0 + ny);
+            if(std::find(blocked.begin(), blocked.end(), cell) != blocked.end()) {
+                continue;
+            }
+
+            distances[next] = distances[local] + 1;
+            queue.push_back(next);
+        }
+    }
+}
+
+bool SectorGraph::_walkSector(int from, int to, const std::vector<int>& blocked, std::vector<int>& path) const {
+    static const int moves[4][2] = {
+        { -1,  0 }, {  1,  0 }, {  0,  1 }, {  0, -1 }
+    };
+    static thread_local std::vector<int> parents;
+    static thread_local std::vector<int> queue;
+
+    if(from == to) {
+        return true;
+    }
+
+    const int x0 = (from / _height) / SIZE * SIZE, y0 = (from % _height) / SIZE * SIZE;
+    const unsigned char* passable = &_tiledPassable[_getTiled(x0, y0)];
+    const int source = (from / _height - x0) * SIZE + (from % _height - y0);
+    const int target = (to / _height - x0) * SIZE + (to % _height - y0);
+
+    parents.assign(SIZE * SIZE, -1);
+    queue.clear();
+
+    parents[source] = source;
+    queue.push_back(source);
+
+    for(std::size_t head = 0; head < queue.size() && parents[target] < 0; ++head) {
+        const int local = queue[head];
+        const int lx = local / SIZE, ly = local % SIZE;
+
+        for(const int* move : moves) {
+            int nx = lx + move[0], ny = ly + move[1];
+            if(nx < 0 || ny < 0 || nx >= SIZE || ny >= SIZE) {
+                continue;
+            }
+
+            int next = nx * SIZE + ny;
+            if(parents[next] >= 0 || !passable[next]) {
+                continue;
+            }
+
+            int cell = (x0 + nx) * _height + (y0 + ny);
+            if(std::find(blocked.begin(), blocked.end(), cell) != blocked.end()) {
+                continue;
+            }
+
+            parents[next] = local;
+            queue.push_back(next);
+        }
+    }
+
+    if(parents[target] < 0) {
+        return false;
+    }
+
+    const std::size_t begin = path.size();
+    for(int local = target; local != source; local = parents[local]) {
+        path.push_back((x0 + local / SIZE) * _height + (y0 + local % SIZE));
+    }
+    std::reverse(path.begin() + begin, path.end());
+
+    return true;
+}
@@ -0,0 +1,78 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef SECTORGRAPH_H_INCLUDED
+#define SECTORGRAPH_H_INCLUDED
+
+#include <vector>
+#include <cstddef>
+
+class MapIndex;
+
+/**
+ * Hierarchical (HPA*) view of the map for point-to-point queries on large boards.
+ *
+ * The board is cut into SIZE x SIZE sectors. Every run of EMPTY cells facing each other
+ * across a sector border is an entrance with one or two portals (pairs of cells, one on
+ * each side); portals of one sector are linked by their BFS distances inside the sector.
+ * A query searches this small graph and then refines only the route it found, one sector
+ * at a time, instead of searching the cells of the whole board.
+ *
+ * Built once per map from the hero-free background. Cells are also kept in tiled order
+ * (sector by sector), so the BFS inside one sector touches a small contiguous block.
+ */
+class SectorGraph {
+    public:
+        static const int SIZE = 16;
+
+    public:
+        SectorGraph();
+
+        void compute(const MapIndex& mapIndex);
+
+        int getSectorCount() const { return _sectorsX * _sectorsY; }
+        int getPortalCount() const { return _nodes.size(); }
+        // Sector of cell 'index' (x * height + y)
+        int getSector(int index) const { return (index / _height) / SIZE * _sectorsY + (index % _height) / SIZE; }
+
+        // Path under the Path rules (only EMPTY cells are walked through, the start and the goal may be
+        // any tile) where cells from 'blocked' (heroes) can't be walked through either. Goes through the
+        // portals, so it may be a few steps longer than the shortest one.
+        // Returns the number of cells on the path (as Path::Result::distance), 0 if there is none and -1
+        // if heroes may hide the answer from the portals (the caller has to search the cells instead): a
+        // hero stands on a portal, blocks the route inside a sector, or nothing was found with heroes around;
+        // cell indices of the path are written to 'path' and portals expanded to 'expansions' when given
+        int query(const MapIndex& mapIndex, const std::vector<int>& blocked, int start, int goal,
+                  std::vector<int>* path = NULL, unsigned int* expansions = NULL) const;
+
+    private:
+        struct Edge {
+            int to;
+            int cost;
+        };
+
+        // Tiled position of a cell: sector * SIZE * SIZE + place inside the sector
+        int _getTiled(int x, int y) const { return ((x / SIZE) * _sectorsY + y / SIZE) * SIZE * SIZE + (x % SIZE) * SIZE + (y % SIZE); }
+        // BFS from 'source' inside its sector; calls visitor(cell, distance) for every cell reached
+        template<typename Visitor>
+        void _fillSector(int source, const std::vector<int>& blocked, const Visitor& visitor) const;
+        // Appends the cells after 'from' up to and including 'to' (both in one sector) on a shortest path
+        // inside the sector; returns false if 'to' can't be reached there
+        bool _walkSector(int from, int to, const std::vector<int>& blocked, std::vector<int>& path) const;
+
+        int _width;
+        int _height;
+        int _sectorsX;
+        int _sectorsY;
+        std::vector<unsigned char> _tiledPassable;  // EMPTY cells in tiled order, cells outside the board are not
+        std::vector<int> _nodeOf;                   // cell index -> portal, -1 for other cells
+        std::vector<int> _nodes;                    // portal -> cell index, portals of one sector side by side
+        std::vector<int> _sectorBegin;              // sector -> first of its portals, sectors + 1 entries
+        std::vector<int> _edgeBegin;                // portal -> first of its edges, portals + 1 entries
+        std::vector<Edge> _edges;
+};
+
+#endif
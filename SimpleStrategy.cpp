@@ -8,42 +8,23 @@
 #include "Path.h"
 
 SimpleStrategy::SimpleStrategy(const Game& game) : Strategy(game) {
-    int heroNumber = _game.state.next_hero_index;
-    Tile playerMine;
-
-    switch(heroNumber) {
-        case 0: playerMine = MINE1; break;
-        case 1: playerMine = MINE2; break;
-        case 2: playerMine = MINE3; break;
-        case 3: playerMine = MINE4; break;
-        default: playerMine = UNKNOWN; break;
-    }
 
-    for(Tile t: {MINE, MINE1, MINE2, MINE3, MINE4}) {
-        if(t != playerMine) {
-            _goal.push_back(t);
-        }
-    }
-    _scheduledUpdate = false;
 }
 
 Direction SimpleStrategy::getMove() {
     int heroNumber = _game.state.next_hero_index;
-    if(_scheduledUpdate) {
-        _newGoal();
-        _scheduledUpdate = false;
-    }
 
-    Path::PathType path = Path::getPath(_game.state, _game.state.heroes[heroNumber].position, _goal);
+    // Goals are picked again every turn: DistanceFields answer them without a search, so a goal
+    // doesn't have to be kept until it is reached to save replanning
+    _newGoal();
+
+    Path::Result path = Path::query(_game.state, _game.state.heroes[heroNumber].position, _goal);
 
-    if(path.size() == 0) {
-        _scheduledUpdate = true;
+    if(!path.found()) {
         return STAY;
-    } else if(path.size() == 1) {
-        _scheduledUpdate = true;
     }
 
-    return Path::getDirection(_game.state.heroes[heroNumber].position, path.front());
+    return path.direction;
 }
 
 void SimpleStrategy::_newGoal() {
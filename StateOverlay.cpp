@@ -0,0 +1,86 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#include "StateOverlay.h"
+
+const int StateOverlay::MAX_MINE_OWNERS;
+
+StateOverlay::StateOverlay(const State& state) : _state(state), _mapIndex(*state.get_map_index()) {
+    reset();
+}
+
+void StateOverlay::setHeroPosition(int heroIndex, const Position& position) {
+    _heroes[heroIndex] = position;
+}
+
+bool StateOverlay::setMineOwner(const Position& mine, int heroIndex) {
+    int mineId = _mapIndex.getMineId(mine);
+    if(mineId < 0) {
+        return false;
+    }
+
+    for(int i = 0; i < _mineCount; ++i) {
+        if(_mineIds[i] == mineId) {
+            _mineOwners[i] = heroIndex;
+            return true;
+        }
+    }
+
+    if(_mineCount == MAX_MINE_OWNERS) {
+        return false;
+    }
+
+    _mineIds[_mineCount] = mineId;
+    _mineOwners[_mineCount] = heroIndex;
+    ++_mineCount;
+
+    return true;
+}
+
+int StateOverlay::getMineOwner(const Position& mine) const {
+    int mineId = _mapIndex.getMineId(mine);
+    if(mineId < 0) {
+        return -1;
+    }
+
+    for(int i = 0; i < _mineCount; ++i) {
+        if(_mineIds[i] == mineId) {
+            return _mineOwners[i];
+        }
+    }
+
+    Tile tile = _state.get_tile_from_background_border_check(mine);
+    return (tile >= MINE1 && tile <= MINE4) ? tile - MINE1 : -1;
+}
+
+void StateOverlay::reset() {
+    for(int i = 0; i < 4; ++i) {
+        _heroes[i] = _state.heroes[i].position;
+    }
+    _mineCount = 0;
+}
+
+Tile StateOverlay::getTile(const Position& position) const {
+    static const Tile heroTiles[4] = { HERO1, HERO2, HERO3, HERO4 };
+    static const Tile heroMineTiles[4] = { MINE1, MINE2, MINE3, MINE4 };
+
+    Tile tile = get_tile_border_check(_state.get_background_tiles(), position);
+
+    if(tile == EMPTY) {
+        for(int i = 0; i < 4; ++i) {
+            if(_heroes[i] == position) {
+                return heroTiles[i];
+            }
+        }
+    } else if(tile == MINE) {
+        int owner = getMineOwner(position);
+        if(owner >= 0) {
+            return heroMineTiles[owner];
+        }
+    }
+
+    return tile;
+}
@@ -0,0 +1,54 @@
+/**
+ * Authors:
+ * Damian Dyńdo
+ * Mikołaj Nowak
+*/
+
+#ifndef STATEOVERLAY_H_INCLUDED
+#define STATEOVERLAY_H_INCLUDED
+
+#include "state.h"
+
+/**
+ * What-if view of a State: heroes moved to other cells and mines given to other owners,
+ * without copying the state (and its four mine sets).
+ *
+ * Everything not overridden is read from the state underneath, which has to outlive the
+ * overlay. Overrides live in fixed arrays, so setting them and answering getTile() never
+ * allocate; Path::query takes an overlay wherever it takes a State.
+ */
+class StateOverlay {
+    public:
+        static const int MAX_MINE_OWNERS = 16;
+
+    public:
+        explicit StateOverlay(const State& state);
+
+        const State& getState() const { return _state; }
+
+        // Puts hero 'heroIndex' on 'position' (its own cell is left EMPTY)
+        void setHeroPosition(int heroIndex, const Position& position);
+        const Position& getHeroPosition(int heroIndex) const { return _heroes[heroIndex]; }
+
+        // Gives 'mine' to hero 'heroIndex' (-1 for no owner); false if it isn't a mine or
+        // MAX_MINE_OWNERS other mines are overridden already
+        bool setMineOwner(const Position& mine, int heroIndex);
+        // Hero index of the owner of 'mine', -1 for no owner (or not a mine)
+        int getMineOwner(const Position& mine) const;
+
+        // Drops all overrides
+        void reset();
+
+        // Same as State::get_tile_from_background_border_check with the overrides applied
+        Tile getTile(const Position& position) const;
+
+    private:
+        const State& _state;
+        const MapIndex& _mapIndex;
+        Position _heroes[4];
+        int _mineCount;
+        int _mineIds[MAX_MINE_OWNERS];
+        int _mineOwners[MAX_MINE_OWNERS];
+};
+
+#endif
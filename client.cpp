@@ -5,6 +5,7 @@
 #include "network.h"
 #include "options.h"
 #include "tiles.h"
+#include "Path.h"
 
 #include <signal.h>
 #include <boost/regex.hpp>
@@ -50,6 +51,8 @@ play_game(const Options& options, Rng& rng)
 
     Game game(initial_json);
 
+    if (options.benchmark_path) Path::benchmark(game.state, std::cout);
+
 #if defined(BOTUCT) || defined(BOTMULTI)
     Bot bot(game, options.uct_constant, options.max_mc_depth, rng);
 #elif defined(BOTRANDOM) || defined(BOTLEARNING)
@@ -2,13 +2,28 @@
 
 #include <boost/regex.hpp>
 
+static
+std::vector<Position>
+get_spawn_positions(const PTree& root)
+{
+    std::vector<Position> spawn_positions;
+    const PTree& child_heroes = root.get_child("game.heroes");
+    for (PTree::const_iterator ti=child_heroes.begin(), tie=child_heroes.end(); ti!=tie; ti++)
+        spawn_positions.push_back(get_position(ti->second.get_child("spawnPos")));
+    return spawn_positions;
+}
+
 Game::Game(const PTree& root) :
     background_tiles(get_background_tiles(root.get_child("game.board"))),
     hashed_background_tiles(make_hashed_pair(background_tiles)),
+    map_index(std::make_shared<MapIndex>(hashed_background_tiles, get_spawn_positions(root))),
     turn_max(root.get<int>("game.maxTurns")),
     turn(root.get<int>("game.turn")),
-    state(root, hashed_background_tiles)
+    state(root, hashed_background_tiles, map_index),
+    distance_fields(state)
 {
+    state.attach(&distance_fields);
+
     assert( state == state );
     assert( hash_value(state) == hash_value(state) );
 
@@ -2,6 +2,7 @@
 
 #include "hashed.h"
 #include "state.h"
+#include "DistanceField.h"
 
 struct Game
 {
@@ -37,12 +38,14 @@ struct Game
 
     const Tiles background_tiles;
     const HashedPair<Tiles> hashed_background_tiles;
+    const MapIndex::Pointer map_index;
     const HeroInfos hero_infos;
 
     const int turn_max;
     int turn;
 
     State state;
+    DistanceFields distance_fields; // attached to state, repaired on every update
 
 private:
 
@@ -24,7 +24,8 @@ Options parse_options(int argc, char* argv[])
         ("server,s", po::value<std::string>(&options.server_name)->default_value("vindinium.org"), "server name")
         ("map,m", po::value<std::string>(&options.map_name)->default_value(""), "map name")
         ("proxy", po::value<std::string>(&options.proxy)->default_value(""), "SOCKS proxy to use (eg. localhost:4444)")
-        ("collect-map", po::value<bool>(&options.collect_map)->default_value(false), "save game map");
+        ("collect-map", po::value<bool>(&options.collect_map)->default_value(false), "save game map")
+        ("benchmark-path", po::value<bool>(&options.benchmark_path)->default_value(false), "time path engines on the initial state");
     po::positional_options_description positional;
 
     try
@@ -14,6 +14,7 @@ struct Options
     double uct_constant;
     int max_mc_depth;
     bool collect_map;
+    bool benchmark_path;
 };
 
 Options
@@ -0,0 +1,287 @@
+#include "packed_state.h"
+
+#include <cassert>
+#include <boost/functional/hash.hpp>
+
+const int PackedState::MAX_MINES;
+
+/// Same as Position::next_to (a hero on the very cell counts too), without building positions
+static inline
+bool
+is_next_to(const PackedState::Hero& hero_aa, const PackedState::Hero& hero_bb)
+{
+    const int delta_x = hero_aa.x-hero_bb.x;
+    const int delta_y = hero_aa.y-hero_bb.y;
+    return (delta_x < 0 ? -delta_x : delta_x) + (delta_y < 0 ? -delta_y : delta_y) <= 1;
+}
+
+Position
+PackedState::Hero::get_position() const
+{
+    return Position(x, y);
+}
+
+Position
+PackedState::Hero::get_spawn_position() const
+{
+    return Position(spawn_x, spawn_y);
+}
+
+void
+PackedState::Hero::set_position(const Position& position)
+{
+    x = position.x;
+    y = position.y;
+}
+
+int
+PackedState::Hero::get_mine_count() const
+{
+    return __builtin_popcountll(mines);
+}
+
+PackedState::PackedState() :
+    next_hero_index(0),
+    background_tiles(NULL),
+    map_index(NULL)
+{
+    for (int kk=0; kk<4; kk++)
+    {
+        Hero& hero = heroes[kk];
+        hero.x = hero.y = hero.spawn_x = hero.spawn_y = -1;
+        hero.life = hero.gold = -1;
+        hero.crashed = true;
+        hero.mines = 0;
+    }
+}
+
+PackedState::PackedState(const State& state) :
+    next_hero_index(state.next_hero_index),
+    background_tiles(&state.get_background_tiles()),
+    map_index(state.get_map_index().get())
+{
+    assert( fits(*map_index) );
+
+    for (int kk=0; kk<4; kk++)
+    {
+        const State::Hero& source = state.heroes[kk];
+        Hero& hero = heroes[kk];
+
+        hero.set_position(source.position);
+        hero.spawn_x = source.spawn_position.x;
+        hero.spawn_y = source.spawn_position.y;
+        hero.life = source.life;
+        hero.gold = source.gold;
+        hero.crashed = source.crashed;
+        hero.mines = 0;
+        for (PositionsSet::const_iterator mi=source.mine_positions.begin(), mie=source.mine_positions.end(); mi!=mie; mi++)
+            hero.mines |= std::uint64_t(1) << map_index->getMineId(*mi);
+    }
+}
+
+bool
+PackedState::fits(const MapIndex& map_index)
+{
+    return map_index.getMineCount() <= MAX_MINES;
+}
+
+void
+PackedState::unpack(State& state) const
+{
+    assert( state.get_map_index().get() == map_index );
+
+    const std::vector<Position>& mines = map_index->getMines();
+
+    for (int kk=0; kk<4; kk++)
+    {
+        const Hero& hero = heroes[kk];
+        State::Hero& target = state.heroes[kk];
+
+        target.position = hero.get_position();
+        target.spawn_position = hero.get_spawn_position();
+        target.life = hero.life;
+        target.gold = hero.gold;
+        target.crashed = hero.crashed;
+        target.mine_positions.clear();
+        for (std::uint64_t mask=hero.mines; mask; mask&=mask-1)
+            target.mine_positions.insert(target.mine_positions.end(), mines[__builtin_ctzll(mask)]);
+    }
+
+    state.next_hero_index = next_hero_index;
+    state.refresh();
+}
+
+Tile
+PackedState::get_tile(const Position& position) const
+{
+    static const Tile hero_tiles[4] = {HERO1, HERO2, HERO3, HERO4};
+    static const Tile hero_mine_tiles[4] = {MINE1, MINE2, MINE3, MINE4};
+
+    const Tile tile = get_tile_border_check(*background_tiles, position);
+
+    if (tile == EMPTY)
+    {
+        for (int kk=0; kk<4; kk++)
+            if (heroes[kk].x == position.x && heroes[kk].y == position.y) return hero_tiles[kk];
+    }
+    else if (tile == MINE)
+    {
+        const int owner = get_mine_owner(map_index->getMineId(position));
+        if (owner >= 0) return hero_mine_tiles[owner];
+    }
+
+    return tile;
+}
+
+int
+PackedState::get_mine_owner(const int& mine_id) const
+{
+    const std::uint64_t bit = std::uint64_t(1) << mine_id;
+
+    for (int kk=0; kk<4; kk++)
+        if (heroes[kk].mines & bit) return kk;
+
+    return -1;
+}
+
+void
+PackedState::chain_respawn(const int& killed_hero_index, const int& killer_hero_index)
+{
+    assert( killer_hero_index != killed_hero_index ); // no suicide
+
+    Hero& killed_hero = heroes[killed_hero_index];
+
+    int crushed_hero_index = -1;
+    for (int kk=0; kk<4 && crushed_hero_index<0; kk++)
+        if (heroes[kk].x == killed_hero.spawn_x && heroes[kk].y == killed_hero.spawn_y) crushed_hero_index = kk;
+
+    killed_hero.x = killed_hero.spawn_x;
+    killed_hero.y = killed_hero.spawn_y;
+    killed_hero.life = 100;
+    if (killer_hero_index >= 0) heroes[killer_hero_index].mines |= killed_hero.mines; // steal mines
+    killed_hero.mines = 0;
+
+    if (crushed_hero_index < 0) return;
+    if (killed_hero_index == crushed_hero_index) return; // dead on self spawning point
+
+    chain_respawn(crushed_hero_index, killed_hero_index);
+}
+
+void
+PackedState::update(const Direction& direction)
+{
+    assert( next_hero_index < 4 );
+    const int hero_index = next_hero_index;
+    Hero& hero = heroes[hero_index];
+
+    // move hero and resolve local interaction
+    if (direction != STAY)
+    {
+        Position target_position = hero.get_position();
+        target_position.with_direction(direction);
+        const Tile target_tile = get_tile_border_check(*background_tiles, target_position);
+
+        switch (target_tile)
+        {
+        case EMPTY:
+            {
+                bool occupied = false;
+                for (int kk=0; kk<4; kk++)
+                    occupied = occupied || (heroes[kk].x == target_position.x && heroes[kk].y == target_position.y);
+                if (!occupied) hero.set_position(target_position);
+            }
+            break;
+        case TAVERN:
+            if (hero.gold < 2) break;
+            hero.gold -= 2;
+            hero.life += 50;
+            if (hero.life > 100) hero.life = 100;
+            break;
+        case MINE:
+            {
+                const std::uint64_t bit = std::uint64_t(1) << map_index->getMineId(target_position);
+                if (hero.mines & bit) break;
+                hero.life -= 20;
+                if (hero.life <= 0) break;
+                for (int kk=0; kk<4; kk++)
+                    heroes[kk].mines &= ~bit;
+                hero.mines |= bit;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // respawn if dead
+    if (hero.life <= 0) chain_respawn(hero_index, -1);
+
+    // resolve hero fights
+    for (int kk=0; kk<4; kk++)
+    {
+        if (kk == hero_index) continue;
+
+        Hero& target_hero = heroes[kk];
+
+        if (!is_next_to(target_hero, hero)) continue;
+
+        target_hero.life -= 20;
+        if (target_hero.life > 0) continue;
+
+        chain_respawn(kk, hero_index);
+    }
+
+    // thirst
+    if (hero.life > 1) hero.life--;
+
+    // mining
+    hero.gold += hero.get_mine_count();
+
+    // tick next_hero_index
+    next_hero_index++;
+    next_hero_index %= 4;
+}
+
+Hash
+hash_value(const PackedState& state)
+{
+    Hash seed = 5465763;
+    for (int kk=0; kk<4; kk++)
+    {
+        const PackedState::Hero& hero = state.heroes[kk];
+        boost::hash_combine(seed, hero.x);
+        boost::hash_combine(seed, hero.y);
+        boost::hash_combine(seed, hero.life);
+        boost::hash_combine(seed, hero.gold);
+        boost::hash_combine(seed, hero.crashed);
+        boost::hash_combine(seed, hero.mines);
+    }
+    boost::hash_combine(seed, state.background_tiles);
+    boost::hash_combine(seed, state.next_hero_index);
+    return seed;
+}
+
+bool
+operator==(const PackedState& state_aa, const PackedState& state_bb)
+{
+    if (state_aa.next_hero_index != state_bb.next_hero_index) return false;
+    if (state_aa.background_tiles != state_bb.background_tiles) return false;
+
+    for (int kk=0; kk<4; kk++)
+    {
+        const PackedState::Hero& hero_aa = state_aa.heroes[kk];
+        const PackedState::Hero& hero_bb = state_bb.heroes[kk];
+        if (hero_aa.x != hero_bb.x || hero_aa.y != hero_bb.y) return false;
+        if (hero_aa.spawn_x != hero_bb.spawn_x || hero_aa.spawn_y != hero_bb.spawn_y) return false;
+        if (hero_aa.life != hero_bb.life || hero_aa.gold != hero_bb.gold) return false;
+        if (hero_aa.crashed != hero_bb.crashed || hero_aa.mines != hero_bb.mines) return false;
+    }
+
+    return true;
+}
+
+bool
+operator!=(const PackedState& state_aa, const PackedState& state_bb)
+{
+    return !(state_aa == state_bb);
+}
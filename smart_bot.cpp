@@ -7,6 +7,7 @@
 #include "smart_bot.h"
 #include "utils.h"
 #include "Path.h"
+#include "PathSurvey.h"
 
 Bot::Bot(const Game& game) {
     _playerIndex = game.state.next_hero_index;
@@ -38,9 +39,9 @@ Direction Bot::get_move(const Game& game) const
     int playerHP = game.state.heroes[_playerIndex].life;
     int minesHold = game.state.heroes[_playerIndex].mine_positions.size();
 
-    Path::PathType pathToMine;
-    Path::PathType pathToTavern;
-    Path::PathType pathToEnemy[4];
+    Path::Result pathToMine;
+    Path::Result pathToTavern;
+    Path::Result pathToEnemy[4];
     std::vector<Tile> goalTavern = { Tile::TAVERN };
 
     // List enemies that are stronger then us (have more HP then we do)
@@ -53,28 +54,29 @@ Direction Bot::get_move(const Game& game) const
             }
         }
     }
-    int minesCount = 0;
-    int mapSize = game.background_tiles.shape()[0];
-    for(int i = 0; i < mapSize; ++i) {
-        for(int j = 0; j < mapSize; ++j) {
-            Position position(i, j);
-            Tile t = game.state.get_tile_from_background(position);
-            if(t == MINE || t == MINE1 || t == MINE2 || t == MINE3 || t == MINE4) {
-                minesCount++;
-            }
+    // One sweep from our position answers every question below (all with the same heroes avoided):
+    // nearest tavern, weaker enemies and nearest mine we don't own
+    std::vector<Tile> surveyGoals = _otherMines;
+    surveyGoals.push_back(TAVERN);
+    for(int i = 0; i < 4; ++i) {
+        if(i != _playerIndex && game.state.heroes[i].life < playerHP) {
+            surveyGoals.push_back(getHeroFromIndex(i));
         }
     }
+    PathSurvey survey(game.state, playerPosition, surveyGoals, strongerEnemies);
+
+    int minesCount = game.map_index->getMineCount();
     double minesFactor = minesHold * 85 / minesCount;
 
     // If player is wounded and have small number of health go to tavern to regain it (but be careful of enemies)
     // be advised, that if player's hp is smaller than 21 then he's best bet is to go to tavern
-    pathToTavern = Path::getPath(game.state, playerPosition, goalTavern, strongerEnemies);
+    pathToTavern = survey.getNearest(goalTavern);
     if((playerHP < std::min(75.0, minesFactor * minesHold)) ||
        (playerHP < 21 && minesHold > 0) ||
-       (playerHP < 75 && pathToTavern.size() < 3 && pathToTavern.size() > 0))
+       (playerHP < 75 && pathToTavern.distance < 3 && pathToTavern.found()))
     {
-        if(pathToTavern.size() > 0) {
-            return Path::getDirection(playerPosition, pathToTavern.front());
+        if(pathToTavern.found()) {
+            return pathToTavern.direction;
         } else {
             return Direction::STAY; // we can't get to tavern
         }
@@ -97,19 +99,18 @@ Direction Bot::get_move(const Game& game) const
             if(enemyHP < playerHP) {
                 // We do, so calculate if it's work for us
                 int currentEnemyCost = 0;
-                std::vector<Tile> enemyGoal = { getHeroFromIndex(enemyIndex) };
-                pathToEnemy[enemyIndex] = Path::getPath(game.state, playerPosition, enemyGoal, strongerEnemies);
+                pathToEnemy[enemyIndex] = survey.getHero(enemyIndex);
 
-                if(pathToEnemy[enemyIndex].size() > 0) {
-                    currentEnemyCost = (6 * enemyMinesHold * enemyMinesHold) / pathToEnemy[enemyIndex].size();
+                if(pathToEnemy[enemyIndex].found()) {
+                    currentEnemyCost = (6 * enemyMinesHold * enemyMinesHold) / pathToEnemy[enemyIndex].distance;
 
-                    if(enemyHP < playerHP - 20 && pathToEnemy[enemyIndex].size() < 2 && enemyMinesHold > 1) {
+                    if(enemyHP < playerHP - 20 && pathToEnemy[enemyIndex].distance < 2 && enemyMinesHold > 1) {
                         currentEnemyCost = currentEnemyCost + 500;
                     }
 
                     if (currentEnemyCost > bestEnemyCost) {
                         bestEnemyCost = currentEnemyCost;
-                        bestEnemyDirection = Path::getDirection(playerPosition, pathToEnemy[enemyIndex].front());
+                        bestEnemyDirection = pathToEnemy[enemyIndex].direction;
                         bestEnemyIndex = enemyIndex;
                     }
                 }
@@ -120,12 +121,12 @@ Direction Bot::get_move(const Game& game) const
     // Now let's see what is the distance to nearest mine -if it's short then it might be better for us to take it
     // instead of fighting
     int costForMine = -1;
-    pathToMine = Path::getPath(game.state, playerPosition, _otherMines, strongerEnemies);
+    pathToMine = survey.getNearest(_otherMines);
     Direction directionToMine = Direction::STAY;
 
-    if(pathToMine.size() > 0) {
-        costForMine = (20 - pathToMine.size()) * 8;
-        directionToMine = Path::getDirection(playerPosition, pathToMine.front());
+    if(pathToMine.found()) {
+        costForMine = (20 - pathToMine.distance) * 8;
+        directionToMine = pathToMine.direction;
     }
 
     if(bestEnemyCost > costForMine) {
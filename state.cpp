@@ -1,11 +1,54 @@
 #include "state.h"
 
 #include <vector>
+#include <algorithm>
+#include <cstdint>
 #include <boost/functional/hash.hpp>
 
-State::State(const PTree& root, const HashedPair<Tiles>& hashed_background_tiles) :
+/// Features of a state with a Zobrist key each
+enum ZobristFeature
+{
+    ZOBRIST_POSITION,
+    ZOBRIST_LIFE,
+    ZOBRIST_GOLD,
+    ZOBRIST_MINE,
+    ZOBRIST_SPAWN,
+    ZOBRIST_CRASHED,
+    ZOBRIST_TURN
+};
+
+/// Key of (feature, hero, value), mixed on demand with splitmix64 instead of read from tables,
+/// so it needs no setup for any board size and any amount of gold
+static inline
+Hash
+zobrist_key(const ZobristFeature& feature, const int& hero_index, const int& value)
+{
+    std::uint64_t zz = (static_cast<std::uint64_t>(feature) << 56) ^ (static_cast<std::uint64_t>(hero_index & 0xff) << 48) ^ static_cast<std::uint32_t>(value);
+    zz += 0x9e3779b97f4a7c15ULL;
+    zz = (zz ^ (zz >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    zz = (zz ^ (zz >> 27)) * 0x94d049bb133111ebULL;
+    return static_cast<Hash>(zz ^ (zz >> 31));
+}
+
+static inline
+int
+zobrist_position(const Position& position)
+{
+    return (position.x << 16) ^ (position.y & 0xffff);
+}
+
+static inline
+Hash
+zobrist_mine_key(const int& hero_index, const Position& mine)
+{
+    return zobrist_key(ZOBRIST_MINE, hero_index, zobrist_position(mine));
+}
+
+State::State(const PTree& root, const HashedPair<Tiles>& hashed_background_tiles, const MapIndex::Pointer& map_index) :
     next_hero_index(root.get<int>("game.turn") % 4),
-    hashed_background_tiles(hashed_background_tiles)
+    hashed_background_tiles(hashed_background_tiles),
+    tiles_full(hashed_background_tiles.value),
+    map_index(map_index)
 {
     // init heroes
     const OwnedMines owned_mines = get_owned_mines(root.get_child("game.board"));
@@ -24,6 +67,8 @@ State::State(const PTree& root, const HashedPair<Tiles>& hashed_background_tiles
         assert( kk < 4 );
         kk++;
     }
+
+    refresh();
 }
 
 void
@@ -32,6 +77,28 @@ State::update(const PTree& root)
     // update heroes
     const OwnedMines owned_mines = get_owned_mines(root.get_child("game.board"));
 
+    if (observer_link.observer)
+    {
+        // report mines changing hands before heroes forget their previous mines
+        for (int kk=0; kk<4; kk++)
+            for (PositionsSet::const_iterator mi=owned_mines[kk].begin(), mie=owned_mines[kk].end(); mi!=mie; mi++)
+            {
+                int previous_owner = -1;
+                for (int ll=0; ll<4; ll++)
+                    if (heroes[ll].mine_positions.find(*mi) != heroes[ll].mine_positions.end()) previous_owner = ll;
+                if (previous_owner != kk) notify_mine_taken(*mi, previous_owner, kk);
+            }
+
+        for (int kk=0; kk<4; kk++)
+            for (PositionsSet::const_iterator mi=heroes[kk].mine_positions.begin(), mie=heroes[kk].mine_positions.end(); mi!=mie; mi++)
+            {
+                bool still_owned = false;
+                for (int ll=0; ll<4; ll++)
+                    if (owned_mines[ll].find(*mi) != owned_mines[ll].end()) still_owned = true;
+                if (!still_owned) notify_mine_taken(*mi, kk, -1);
+            }
+    }
+
     int kk = 0;
     const PTree& child_heroes = root.get_child("game.heroes");
     for (PTree::const_iterator ti=child_heroes.begin(), tie=child_heroes.end(); ti!=tie; ti++)
@@ -40,7 +107,9 @@ State::update(const PTree& root)
         const int id = ti->second.get<int>("id");
         assert( kk+1 == id );
 #endif
+        const Position previous_position = heroes[kk].position;
         heroes[kk].update(ti->second, owned_mines[kk]);
+        if (previous_position != heroes[kk].position) notify_hero_moved(kk, previous_position, heroes[kk].position);
 
         assert( kk < 4 );
         kk++;
@@ -48,10 +117,12 @@ State::update(const PTree& root)
 
     // update next_hero_index
     next_hero_index = root.get<int>("game.turn") % 4;
+
+    refresh();
 }
 
 void
-State::chain_respawn(const int& killed_hero_index, const int& killer_hero_index)
+State::chain_respawn(const int& killed_hero_index, const int& killer_hero_index, UndoRecord* record)
 {
     assert( killer_hero_index != killed_hero_index ); // no suicide
 
@@ -66,13 +137,30 @@ State::chain_respawn(const int& killed_hero_index, const int& killer_hero_index)
         if (respawn_tile == HERO4) crushed_hero_index = 3;
     }
 
-    killed_hero.position = killed_hero.spawn_position;
+    move_hero(killed_hero_index, killed_hero.spawn_position);
     killed_hero.life = 100;
     if (killer_hero_index >= 0) // steal mines
     {
         Hero& killer_hero = heroes[killer_hero_index];
         for (PositionsSet::const_iterator mi=killed_hero.mine_positions.begin(), mie=killed_hero.mine_positions.end(); mi!=mie; mi++)
+        {
             killer_hero.mine_positions.insert(*mi);
+            zobrist_hash ^= zobrist_mine_key(killer_hero_index, *mi);
+        }
+    }
+    for (PositionsSet::const_iterator mi=killed_hero.mine_positions.begin(), mie=killed_hero.mine_positions.end(); mi!=mie; mi++)
+    {
+        zobrist_hash ^= zobrist_mine_key(killed_hero_index, *mi);
+        paint_mine(*mi, killer_hero_index);
+        notify_mine_taken(*mi, killed_hero_index, killer_hero_index);
+    }
+    if (record)
+    {
+        const int respawn_index = record->respawn_count++;
+        assert( respawn_index < 4 );
+        record->respawned_hero_indexes[respawn_index] = killed_hero_index;
+        record->killer_hero_indexes[respawn_index] = killer_hero_index;
+        record->lost_mines[respawn_index].swap(killed_hero.mine_positions);
     }
     killed_hero.mine_positions.clear();
 
@@ -81,12 +169,79 @@ State::chain_respawn(const int& killed_hero_index, const int& killer_hero_index)
 
     assert( killed_hero_index != crushed_hero_index );
 
-    chain_respawn(crushed_hero_index, killed_hero_index);
+    chain_respawn(crushed_hero_index, killed_hero_index, record);
 }
 
 
 void
 State::update(const Direction& direction)
+{
+    play(direction, NULL);
+}
+
+State::UndoRecord
+State::apply(const Direction& direction)
+{
+    UndoRecord record;
+    play(direction, &record);
+    return record;
+}
+
+void
+State::undo(UndoRecord& record)
+{
+    static const Tile hero_index_to_mines[4] = {
+        MINE1,
+        MINE2,
+        MINE3,
+        MINE4
+    };
+
+    // respawns in reverse order, each hero gets its mines back from its killer
+    for (int ii=record.respawn_count-1; ii>=0; ii--)
+    {
+        const int& killed_hero_index = record.respawned_hero_indexes[ii];
+        const int& killer_hero_index = record.killer_hero_indexes[ii];
+        PositionsSet& lost_mines = record.lost_mines[ii];
+
+        for (PositionsSet::const_iterator mi=lost_mines.begin(), mie=lost_mines.end(); mi!=mie; mi++)
+        {
+            if (killer_hero_index >= 0) heroes[killer_hero_index].mine_positions.erase(*mi);
+            paint_mine(*mi, killed_hero_index);
+            notify_mine_taken(*mi, killer_hero_index, killed_hero_index);
+        }
+        heroes[killed_hero_index].mine_positions.swap(lost_mines);
+        lost_mines.clear();
+    }
+    record.respawn_count = 0;
+
+    if (record.taken_mine != Position())
+    {
+        const int hero_index = record.next_hero_index;
+        assert( get_tile(tiles_full, record.taken_mine) == hero_index_to_mines[hero_index] );
+
+        heroes[hero_index].mine_positions.erase(record.taken_mine);
+        if (record.taken_mine_owner >= 0) heroes[record.taken_mine_owner].mine_positions.insert(record.taken_mine);
+        paint_mine(record.taken_mine, record.taken_mine_owner);
+        notify_mine_taken(record.taken_mine, hero_index, record.taken_mine_owner);
+    }
+
+    for (int kk=0; kk<4; kk++)
+    {
+        const UndoRecord::HeroRecord& hero_record = record.heroes[kk];
+        Hero& hero = heroes[kk];
+
+        if (hero.position != hero_record.position) move_hero(kk, hero_record.position);
+        hero.life = hero_record.life;
+        hero.gold = hero_record.gold;
+    }
+
+    next_hero_index = record.next_hero_index;
+    zobrist_hash = record.zobrist_hash;
+}
+
+void
+State::play(const Direction& direction, UndoRecord* record)
 {
     static const Tile hero_index_to_mines[4] = {
         MINE1,
@@ -116,6 +271,23 @@ State::update(const Direction& direction)
     const size_t hero_index = next_hero_index;
     Hero& hero = heroes[hero_index];
 
+    if (record)
+    {
+        for (int kk=0; kk<4; kk++)
+        {
+            record->heroes[kk].position = heroes[kk].position;
+            record->heroes[kk].life = heroes[kk].life;
+            record->heroes[kk].gold = heroes[kk].gold;
+        }
+        record->next_hero_index = next_hero_index;
+        record->zobrist_hash = zobrist_hash;
+    }
+
+    // positions, lives and gold are rekeyed once the turn is resolved, mines as they change hands
+    for (int kk=0; kk<4; kk++)
+        zobrist_hash ^= get_hero_zobrist(kk, heroes[kk]);
+    zobrist_hash ^= zobrist_key(ZOBRIST_TURN, 0, next_hero_index);
+
     /*{
         const Tiles& tiles_full = get_tiles_full();
 
@@ -146,7 +318,7 @@ State::update(const Direction& direction)
         case WOOD:
             break;
         case EMPTY:
-            hero.position = target_position;
+            move_hero(hero_index, target_position);
             break;
         case TAVERN:
             if (hero.gold < 2) break;
@@ -168,18 +340,27 @@ State::update(const Direction& direction)
             hero.life -= 20;
             if (hero.life <= 0) break;
             hero.mine_positions.insert(target_position);
+            zobrist_hash ^= zobrist_mine_key(hero_index, target_position);
             const int spoiled_hero_index = tile_to_hero_indexes[static_cast<int>(target_tile)];
+            paint_mine(target_position, hero_index);
+            notify_mine_taken(target_position, spoiled_hero_index, hero_index);
+            if (record)
+            {
+                record->taken_mine = target_position;
+                record->taken_mine_owner = spoiled_hero_index;
+            }
             if (spoiled_hero_index < 0) break;
             Hero& spoiled_hero = heroes[spoiled_hero_index];
             assert( spoiled_hero.mine_positions.find(target_position) != spoiled_hero.mine_positions.end() );
             spoiled_hero.mine_positions.erase(target_position);
+            zobrist_hash ^= zobrist_mine_key(spoiled_hero_index, target_position);
             break;
         }
 
     }
 
     // respawn if dead
-    if (hero.life <= 0) chain_respawn(hero_index, -1);
+    if (hero.life <= 0) chain_respawn(hero_index, -1, record);
 
     // resolve hero fights
     for (size_t kk=0; kk<heroes.size(); kk++)
@@ -194,7 +375,7 @@ State::update(const Direction& direction)
         target_hero.life -= 20;
         if (target_hero.life > 0) continue;
 
-        chain_respawn(kk, hero_index);
+        chain_respawn(kk, hero_index, record);
     }
 
     // thirst
@@ -206,6 +387,10 @@ State::update(const Direction& direction)
     // tick next_hero_index
     next_hero_index++;
     next_hero_index %= 4;
+
+    for (int kk=0; kk<4; kk++)
+        zobrist_hash ^= get_hero_zobrist(kk, heroes[kk]);
+    zobrist_hash ^= zobrist_key(ZOBRIST_TURN, 0, next_hero_index);
 }
 
 void
@@ -246,15 +431,15 @@ Hash
 hash_value(const State& state)
 {
     Hash seed = 5465763;
-    boost::hash_range(seed, state.heroes.begin(), state.heroes.end());
+    boost::hash_combine(seed, state.zobrist_hash);
     boost::hash_combine(seed, state.hashed_background_tiles.hash);
-    boost::hash_combine(seed, state.next_hero_index);
     return seed;
 }
 
 bool
 operator==(const State& state_aa, const State& state_bb)
 {
+    if (state_aa.zobrist_hash != state_bb.zobrist_hash) return false;
     if (state_aa.next_hero_index !=  state_bb.next_hero_index) return false;
     if (state_aa.hashed_background_tiles != state_bb.hashed_background_tiles) return false;
 
@@ -352,36 +537,148 @@ State::process_background_tile(const Tile& tile, const Position& position) const
 Tile
 State::get_tile_from_background(const Position& position) const
 {
-    return process_background_tile(get_tile(hashed_background_tiles.value, position), position);
+    return get_tile(tiles_full, position);
 }
 
 Tile
 State::get_tile_from_background_border_check(const Position& position) const
 {
-    return process_background_tile(get_tile_border_check(hashed_background_tiles.value, position), position);
+    return get_tile_border_check(tiles_full, position);
+}
+
+const Tiles&
+State::get_background_tiles() const
+{
+    return hashed_background_tiles.value;
+}
+
+const MapIndex::Pointer&
+State::get_map_index() const
+{
+    return map_index;
 }
 
-Tiles
+const Tiles&
 State::get_tiles_full() const
 {
-    Tiles tiles(hashed_background_tiles.value);
+    return tiles_full;
+}
 
-    static const Tile hero_tiles[4] = {HERO1, HERO2, HERO3, HERO4};
+void
+State::move_hero(const int& hero_index, const Position& position)
+{
+    Hero& hero = heroes[hero_index];
+    const Position previous_position = hero.position;
+
+    notify_hero_moved(hero_index, previous_position, position);
+    hero.position = position;
+
+    paint_hero_cell(previous_position);
+    paint_hero_cell(position);
+}
+
+void
+State::paint_hero_cell(const Position& position)
+{
+    get_tile(tiles_full, position) = process_background_tile(get_tile(hashed_background_tiles.value, position), position);
+}
+
+void
+State::paint_mine(const Position& mine, const int& hero_index)
+{
     static const Tile hero_mine_tiles[4] = {MINE1, MINE2, MINE3, MINE4};
 
+    get_tile(tiles_full, mine) = (hero_index < 0) ? MINE : hero_mine_tiles[hero_index];
+}
+
+void
+State::paint_tiles_full()
+{
+    const Tiles& background = hashed_background_tiles.value;
+    std::copy(background.origin(), background.origin()+background.num_elements(), tiles_full.origin());
+
+    for (int kk=0; kk<4; kk++)
+        for (PositionsSet::const_iterator mi=heroes[kk].mine_positions.begin(), mie=heroes[kk].mine_positions.end(); mi!=mie; mi++)
+        {
+            assert( get_tile(background, *mi) == MINE );
+            paint_mine(*mi, kk);
+        }
+
+    for (int kk=0; kk<4; kk++)
+        paint_hero_cell(heroes[kk].position);
+}
+
+Hash
+State::get_hero_zobrist(const int& hero_index, const Hero& hero)
+{
+    return zobrist_key(ZOBRIST_POSITION, hero_index, zobrist_position(hero.position)) ^
+           zobrist_key(ZOBRIST_LIFE, hero_index, hero.life) ^
+           zobrist_key(ZOBRIST_GOLD, hero_index, hero.gold);
+}
+
+void
+State::refresh()
+{
+    paint_tiles_full();
+
+    zobrist_hash = zobrist_key(ZOBRIST_TURN, 0, next_hero_index);
+
     for (int kk=0; kk<4; kk++)
     {
         const Hero& hero = heroes[kk];
-        get_tile(tiles, hero.position) = hero_tiles[kk];
+        zobrist_hash ^= get_hero_zobrist(kk, hero);
+        zobrist_hash ^= zobrist_key(ZOBRIST_SPAWN, kk, zobrist_position(hero.spawn_position));
+        zobrist_hash ^= zobrist_key(ZOBRIST_CRASHED, kk, hero.crashed);
         for (PositionsSet::const_iterator mi=hero.mine_positions.begin(), mie=hero.mine_positions.end(); mi!=mie; mi++)
-        {
-            Tile& tile = get_tile(tiles, *mi);
-            assert( tile == MINE );
-            tile = hero_mine_tiles[kk];
-        }
+            zobrist_hash ^= zobrist_mine_key(kk, *mi);
     }
+}
+
+void
+State::attach(StateObserver* observer)
+{
+    observer_link.observer = observer;
+}
+
+StateObserver*
+State::get_observer() const
+{
+    return observer_link.observer;
+}
 
-    return tiles;
+void
+State::notify_hero_moved(const int& hero_index, const Position& from, const Position& to)
+{
+    if (observer_link.observer) observer_link.observer->hero_moved(hero_index, from, to);
+}
+
+void
+State::notify_mine_taken(const Position& mine, const int& from_hero_index, const int& to_hero_index)
+{
+    if (observer_link.observer) observer_link.observer->mine_taken(mine, from_hero_index, to_hero_index);
+}
+
+State::UndoRecord::UndoRecord() :
+    next_hero_index(0),
+    zobrist_hash(0),
+    taken_mine(Position()),
+    taken_mine_owner(-1),
+    respawn_count(0)
+{
+}
+
+State::ObserverLink::ObserverLink() :
+    observer(NULL)
+{
+}
+
+State::ObserverLink::ObserverLink(const ObserverLink&) :
+    observer(NULL)
+{
+}
+
+StateObserver::~StateObserver()
+{
 }
 
 State::Hero::Hero() :
@@ -2,8 +2,25 @@
 
 #include "hashed.h"
 #include "network.h"
+#include "MapIndex.h"
 #include <boost/array.hpp>
 
+/// Receives the changes State::update makes, so derived data (e.g. DistanceFields)
+/// can be repaired instead of rebuilt. Hero index -1 stands for no owner.
+struct StateObserver
+{
+    virtual
+    ~StateObserver();
+
+    virtual
+    void
+    hero_moved(const int& hero_index, const Position& from, const Position& to) = 0;
+
+    virtual
+    void
+    mine_taken(const Position& mine, const int& from_hero_index, const int& to_hero_index) = 0;
+};
+
 struct State
 {
     struct Hero
@@ -23,7 +40,33 @@ struct State
 
     typedef boost::array<Hero, 4> Heroes;
 
-    State(const PTree& root, const HashedPair<Tiles>& background_tiles);
+    /// What apply changed, for undo: heroes before the move, the mine the moving hero took
+    /// and, in order, the heroes respawned with the mines they lost
+    struct UndoRecord
+    {
+        UndoRecord();
+
+        struct HeroRecord
+        {
+            Position position;
+            int life;
+            int gold;
+        };
+
+        HeroRecord heroes[4];
+        int next_hero_index;
+        Hash zobrist_hash;
+
+        Position taken_mine; // (-1,-1) if the moving hero took no mine
+        int taken_mine_owner; // -1 for a neutral mine
+
+        int respawn_count; // a hero respawns at most once per move
+        int respawned_hero_indexes[4];
+        int killer_hero_indexes[4]; // -1 for none
+        PositionsSet lost_mines[4]; // moved out of the respawned hero, not copied
+    };
+
+    State(const PTree& root, const HashedPair<Tiles>& background_tiles, const MapIndex::Pointer& map_index);
 
     void
     update(const PTree& root);
@@ -31,6 +74,15 @@ struct State
     void
     update(const Direction& direction);
 
+    /// Same move as update, returning what undo needs to take it back
+    UndoRecord
+    apply(const Direction& direction);
+
+    /// Takes back the last applied move (moves are undone in reverse order); the observer is told
+    /// of every change as with update, and 'record' is left without its mines
+    void
+    undo(UndoRecord& record);
+
     void
     status(std::ostream& os) const;
 
@@ -47,9 +99,29 @@ struct State
     Tile
     get_tile_from_background_border_check(const Position& position) const;
 
-    Tiles
+    /// Background with heroes and mine owners, kept up to date by both update methods
+    const Tiles&
     get_tiles_full() const;
 
+    /// Attached observer is notified by both update methods; copies of the state start detached
+    void
+    attach(StateObserver* observer);
+
+    StateObserver*
+    get_observer() const;
+
+    const Tiles&
+    get_background_tiles() const;
+
+    /// Taverns, mines, spawns and adjacency of the map, shared with the game
+    const MapIndex::Pointer&
+    get_map_index() const;
+
+    /// Recomputes the hash and the full tiles from heroes and turn; both update methods keep them
+    /// current, so this is only needed after heroes or next_hero_index were changed directly
+    void
+    refresh();
+
     Heroes heroes;
 
     int next_hero_index;
@@ -59,8 +131,46 @@ private:
     Tile
     process_background_tile(const Tile& tile, const Position& position) const;
 
+    /// update and apply, recording into 'record' unless it is null
+    void
+    play(const Direction& direction, UndoRecord* record);
+
     void
-    chain_respawn(const int& killed_hero_index, const int& killer_hero_index);
+    chain_respawn(const int& killed_hero_index, const int& killer_hero_index, UndoRecord* record);
+
+    /// Moves a hero, telling the observer and repainting both cells of the full tiles
+    void
+    move_hero(const int& hero_index, const Position& position);
+
+    /// Repaints a cell of the full tiles with the heroes on it (the first one shows, as in process_background_tile)
+    void
+    paint_hero_cell(const Position& position);
+
+    /// Repaints a mine of the full tiles for its new owner, -1 for none
+    void
+    paint_mine(const Position& mine, const int& hero_index);
+
+    void
+    paint_tiles_full();
+
+    void
+    notify_hero_moved(const int& hero_index, const Position& from, const Position& to);
+
+    void
+    notify_mine_taken(const Position& mine, const int& from_hero_index, const int& to_hero_index);
+
+    /// Zobrist keys of the position, life and gold of a hero (mines are keyed one by one)
+    static
+    Hash
+    get_hero_zobrist(const int& hero_index, const Hero& hero);
+
+    struct ObserverLink
+    {
+        ObserverLink();
+        ObserverLink(const ObserverLink&);
+
+        StateObserver* observer;
+    };
 
     friend
     Hash
@@ -72,6 +182,16 @@ private:
 
     const HashedPair<Tiles> hashed_background_tiles;
 
+    /// Background with heroes and mines painted over it, so tile lookups are a single read
+    Tiles tiles_full;
+
+    MapIndex::Pointer map_index;
+
+    ObserverLink observer_link;
+
+    /// Zobrist hash of heroes and turn, updated with every change so hash_value is O(1)
+    Hash zobrist_hash;
+
 };
 
 std::ostream&